@@ -92,8 +92,7 @@ int main()
         // --- Draw ---
         asw::display::clear(asw::color::darkslategray);
 
-        const int count = asw::input::get_controller_count();
-        if (count == 0) {
+        if (!asw::input::is_controller_connected(0)) {
             // No controller – show a simple message indicator
             asw::draw::rect_fill({ 250.0F, 270.0F, 300.0F, 60.0F }, asw::color::darkred);
             asw::draw::rect({ 250.0F, 270.0F, 300.0F, 60.0F }, asw::color::red);
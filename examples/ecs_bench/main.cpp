@@ -0,0 +1,87 @@
+/// @file main.cpp
+/// @brief Game object vs entity component system update benchmark
+///
+/// Demonstrates:
+///   - Creating entities with Transform and Physics components
+///   - Running the built in physics system from a scene's world
+///   - Comparing the cost against the same motion done by GameObjects
+///
+/// Runs headless, nothing is drawn.
+
+#include <asw/asw.h>
+
+#include <chrono>
+
+namespace {
+
+constexpr int TICKS = 200;
+constexpr float DT = 0.008F;
+
+class BenchScene : public asw::scene::Scene<int> {
+public:
+    using asw::scene::Scene<int>::Scene;
+};
+
+double time_ticks(BenchScene& scene)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < TICKS; ++i) {
+        scene.update(DT);
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+    return elapsed.count() * 1e9 / TICKS;
+}
+
+double bench_objects(asw::scene::SceneManager<int>& manager, int count)
+{
+    BenchScene scene(manager);
+
+    for (int i = 0; i < count; ++i) {
+        auto obj = scene.create_object<asw::game::GameObject>();
+        obj->transform = asw::Quad<float>(static_cast<float>(i), 0.0F, 16.0F, 16.0F);
+        obj->body.velocity = { 1.0F, 2.0F };
+        obj->body.acceleration = { 0.0F, 9.8F };
+    }
+
+    // First update moves the new objects in
+    scene.update(DT);
+
+    return time_ticks(scene);
+}
+
+double bench_entities(asw::scene::SceneManager<int>& manager, int count)
+{
+    BenchScene scene(manager);
+    auto& world = scene.get_world();
+    world.add_system(asw::ecs::physics_system);
+
+    for (int i = 0; i < count; ++i) {
+        const auto e = world.create();
+        world.emplace<asw::ecs::Transform>(
+            e, asw::Quad<float>(static_cast<float>(i), 0.0F, 16.0F, 16.0F));
+
+        auto& body = world.emplace<asw::ecs::Physics>(e);
+        body.velocity = { 1.0F, 2.0F };
+        body.acceleration = { 0.0F, 9.8F };
+    }
+
+    return time_ticks(scene);
+}
+
+} // namespace
+
+int main()
+{
+    asw::scene::SceneManager<int> manager;
+
+    for (const int count : { 1000, 10000, 100000 }) {
+        const auto objects_ns = bench_objects(manager, count);
+        const auto entities_ns = bench_entities(manager, count);
+
+        asw::log::info("{:>6} objects: game objects {:>10.0f} ns/tick, entities {:>10.0f} ns/tick "
+                       "({:.1f}x)",
+            count, objects_ns, entities_ns, objects_ns / entities_ns);
+    }
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+/// @file main.cpp
+/// @brief Job system scheduling overhead benchmark
+///
+/// Demonstrates:
+///   - Fanning out jobs with run() and waiting on a Counter
+///   - Chaining jobs with run_after()
+///   - parallel_for over an index range with different grain sizes
+///
+/// Runs headless, nothing is drawn. Jobs do little or no work, so the timings
+/// are mostly scheduler overhead.
+
+#include <asw/asw.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace {
+
+// Children spawned by each job in the nested benchmark
+constexpr int FAN_OUT = 64;
+
+template <typename Fn> double time_ms(Fn&& fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+void bench_empty_jobs(int count)
+{
+    const auto ms = time_ms([&] {
+        asw::jobs::Counter counter;
+        for (int i = 0; i < count; ++i) {
+            asw::jobs::run([] { }, &counter);
+        }
+        asw::jobs::wait(counter);
+    });
+
+    asw::log::info("{:>8} empty jobs:       {:>8.2f} ms ({:.0f} ns / job)", count, ms,
+        ms * 1e6 / count);
+}
+
+void bench_nested_jobs(int count)
+{
+    // Each job spawns children from a worker, exercising the local deques
+    const auto ms = time_ms([&] {
+        asw::jobs::Counter counter;
+        for (int i = 0; i < count / FAN_OUT; ++i) {
+            asw::jobs::run(
+                [&counter] {
+                    for (int j = 0; j < FAN_OUT - 1; ++j) {
+                        asw::jobs::run([] { }, &counter);
+                    }
+                },
+                &counter);
+        }
+        asw::jobs::wait(counter);
+    });
+
+    asw::log::info("{:>8} nested jobs:      {:>8.2f} ms ({:.0f} ns / job)", count, ms,
+        ms * 1e6 / count);
+}
+
+void bench_chain(int length)
+{
+    // Serial dependency chain, measures job to job latency
+    std::vector<asw::jobs::Counter> links(length);
+
+    const auto ms = time_ms([&] {
+        asw::jobs::run([] { }, &links[0]);
+        for (int i = 1; i < length; ++i) {
+            asw::jobs::run_after(links[i - 1], [] { }, &links[i]);
+        }
+        asw::jobs::wait(links[length - 1]);
+    });
+
+    asw::log::info("{:>8} chained jobs:     {:>8.2f} ms ({:.0f} ns / link)", length, ms,
+        ms * 1e6 / length);
+}
+
+void bench_parallel_for(size_t count)
+{
+    std::vector<float> values(count, 1.0F);
+
+    auto work = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            values[i] = std::sqrt(values[i] * 1.0001F + 0.5F);
+        }
+    };
+
+    const auto serial_ms = time_ms([&] { work(0, count); });
+    asw::log::info("{:>8} items serial:     {:>8.2f} ms", count, serial_ms);
+
+    for (const size_t grain : { size_t { 64 }, size_t { 1024 }, size_t { 16384 }, size_t { 0 } }) {
+        const auto ms = time_ms([&] { asw::jobs::parallel_for(0, count, grain, work); });
+        asw::log::info("{:>8} items grain {:>5}: {:>8.2f} ms ({:.1f}x)", count, grain, ms,
+            serial_ms / ms);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    asw::jobs::init();
+
+    // Warm up threads and job caches
+    bench_empty_jobs(10000);
+
+    bench_empty_jobs(100000);
+    bench_nested_jobs(100000);
+    bench_chain(10000);
+    bench_parallel_for(4000000);
+
+    asw::jobs::shutdown();
+
+    return 0;
+}
@@ -0,0 +1,251 @@
+/// @file main.cpp
+/// @brief Rollback resimulation benchmark
+///
+/// Demonstrates:
+///   - Running a scene manager in deterministic mode
+///   - Feeding recorded input to every tick with set_tick_input()
+///   - Predicting a remote player's late input, then rolling back and
+///     resimulating once the real input arrives
+///   - Checking that a rolled back run matches one that never mispredicted,
+///     using tick checksums
+///
+/// Runs headless, nothing is drawn.
+
+#include <asw/asw.h>
+
+#include <array>
+#include <chrono>
+#include <vector>
+
+namespace {
+
+constexpr int PLAYERS = 2;
+
+// Ticks the remote player's input arrives late
+constexpr uint64_t INPUT_DELAY = 8;
+
+constexpr uint64_t TICKS = 1200;
+
+constexpr uint8_t BUTTON_LEFT = 1U << 0U;
+constexpr uint8_t BUTTON_RIGHT = 1U << 1U;
+constexpr uint8_t BUTTON_FIRE = 1U << 2U;
+
+/// @brief Buttons held by each player on one tick.
+using Buttons = std::array<uint8_t, PLAYERS>;
+
+/// @brief Buttons a player holds on a tick, changing every few ticks.
+uint8_t scripted_input(int player, uint64_t tick)
+{
+    const uint64_t step = tick / (5 + (player * 3));
+    return static_cast<uint8_t>(((step * 2654435761ULL) >> 13U) & 0x07U);
+}
+
+class Fighter : public asw::game::GameObject {
+public:
+    void serialize(asw::serialize::BinaryWriter& writer) const override
+    {
+        GameObject::serialize(writer);
+        writer.write_i32(player);
+        writer.write_i32(cooldown);
+    }
+
+    void deserialize(asw::serialize::BinaryReader& reader) override
+    {
+        GameObject::deserialize(reader);
+        player = reader.read_i32();
+        cooldown = reader.read_i32();
+    }
+
+    int player { 0 };
+    int cooldown { 0 };
+};
+
+class Spark : public asw::game::GameObject {
+public:
+    void update(float dt) override
+    {
+        body.velocity.y += asw::random::between(-20.0F, 20.0F) * dt;
+        GameObject::update(dt);
+
+        if (--life <= 0) {
+            alive = false;
+        }
+    }
+
+    void serialize(asw::serialize::BinaryWriter& writer) const override
+    {
+        GameObject::serialize(writer);
+        writer.write_i32(life);
+    }
+
+    void deserialize(asw::serialize::BinaryReader& reader) override
+    {
+        GameObject::deserialize(reader);
+        life = reader.read_i32();
+    }
+
+    int life { 0 };
+};
+
+class ArenaScene : public asw::scene::Scene<int> {
+public:
+    ArenaScene(asw::scene::SceneManager<int>& manager, int sparks, const Buttons& buttons)
+        : Scene(manager)
+        , sparks_per_shot(sparks)
+        , buttons(buttons)
+    {
+    }
+
+    void init() override
+    {
+        // Sparks come and go every tick, and rollbacks recreate them all
+        set_object_pool_limit(1024);
+
+        for (int player = 0; player < PLAYERS; ++player) {
+            auto fighter = create_object<Fighter>();
+            fighter->player = player;
+            fighter->transform
+                = asw::Quad<float>(100.0F + (200.0F * static_cast<float>(player)), 0, 32, 64);
+        }
+    }
+
+    void update(float dt) override
+    {
+        round_ticks++;
+
+        for (auto* fighter : get_object_view<Fighter>()) {
+            const uint8_t held = buttons[fighter->player];
+            const float dir = static_cast<float>((held & BUTTON_RIGHT) != 0)
+                - static_cast<float>((held & BUTTON_LEFT) != 0);
+            fighter->body.velocity.x = dir * 120.0F;
+
+            if (fighter->cooldown > 0) {
+                fighter->cooldown--;
+            } else if ((held & BUTTON_FIRE) != 0) {
+                fighter->cooldown = 10;
+                shoot(*fighter);
+            }
+        }
+
+        Scene::update(dt);
+    }
+
+    void serialize_state(asw::serialize::BinaryWriter& writer) const override
+    {
+        writer.write_u32(round_ticks);
+    }
+
+    void deserialize_state(asw::serialize::BinaryReader& reader) override
+    {
+        round_ticks = reader.read_u32();
+    }
+
+private:
+    void shoot(const Fighter& fighter)
+    {
+        for (int i = 0; i < sparks_per_shot; ++i) {
+            auto spark = create_object<Spark>();
+            spark->transform = asw::Quad<float>(fighter.transform.position, { 4, 4 });
+            spark->body.velocity = { asw::random::between(-200.0F, 200.0F),
+                asw::random::between(-200.0F, 0.0F) };
+            spark->life = asw::random::between(30, 90);
+        }
+    }
+
+    int sparks_per_shot;
+    uint32_t round_ticks { 0 };
+
+    // Set by the tick input function before every tick
+    const Buttons& buttons;
+};
+
+struct RunResult {
+    uint64_t checksum { 0 };
+    double total_ms { 0.0 };
+    asw::scene::RollbackStats rollback;
+};
+
+/// @brief Play a match. With prediction, player 1's input arrives
+/// INPUT_DELAY ticks late and is guessed until then, rolling back whenever
+/// the guess was wrong.
+RunResult play(int sparks, bool predict)
+{
+    std::vector<Buttons> log(TICKS);
+    Buttons buttons {};
+
+    asw::scene::SceneManager<int> manager;
+    manager.register_scene<ArenaScene>(0, manager, sparks, buttons);
+    manager.set_deterministic(true, 1234, INPUT_DELAY * 4);
+    manager.set_rollback_budget(std::chrono::milliseconds(4));
+    manager.set_next_scene(0);
+
+    // Ticks read input from the log, never from devices
+    manager.set_tick_input([&](uint64_t tick) { buttons = log[tick]; });
+
+    const auto start = std::chrono::steady_clock::now();
+
+    while (manager.get_tick() < TICKS) {
+        const uint64_t tick = manager.get_tick();
+
+        // Local input is known right away, the remote player's is predicted
+        // to repeat the last one received
+        log[tick][0] = scripted_input(0, tick);
+        log[tick][1] = predict && tick >= INPUT_DELAY ? log[tick - 1][1] : scripted_input(1, tick);
+
+        manager.update(0.0F);
+
+        if (!predict || tick < INPUT_DELAY) {
+            continue;
+        }
+
+        // The real input of an older tick arrives, correct the guesses made
+        // from it and roll back if they were wrong
+        const uint64_t arrived = tick + 1 - INPUT_DELAY;
+        const uint8_t actual = scripted_input(1, arrived);
+
+        if (log[arrived][1] != actual) {
+            for (uint64_t t = arrived; t <= tick; ++t) {
+                log[t][1] = actual;
+            }
+
+            manager.rollback(arrived);
+        }
+    }
+
+    RunResult result;
+    result.total_ms
+        = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+              .count();
+    result.rollback = manager.get_rollback_stats();
+
+    // Every input before this tick is confirmed, so both runs must agree
+    result.checksum = manager.get_tick_checksum(TICKS - INPUT_DELAY).value_or(0);
+    return result;
+}
+
+} // namespace
+
+int main()
+{
+    asw::serialize::register_type<Fighter>("fighter");
+    asw::serialize::register_type<Spark>("spark");
+
+    for (const int sparks : { 4, 32, 128 }) {
+        const auto reference = play(sparks, false);
+        const auto predicted = play(sparks, true);
+
+        const auto& stats = predicted.rollback;
+        const double resim_per_second = stats.total_ms > 0.0F
+            ? static_cast<double>(stats.resimulated_ticks) * 1000.0 / stats.total_ms
+            : 0.0;
+
+        asw::log::info("{:>3} sparks/shot: {} ticks in {:>7.2f} ms | {:>3} rollbacks, "
+                       "{:>4} ticks resimulated in {:>7.2f} ms, {:>6.0f} ticks/s, {} over "
+                       "budget | in sync {}",
+            sparks, TICKS, predicted.total_ms, stats.rollbacks, stats.resimulated_ticks,
+            stats.total_ms, resim_per_second, stats.over_budget,
+            reference.checksum == predicted.checksum);
+    }
+
+    return 0;
+}
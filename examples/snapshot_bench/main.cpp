@@ -0,0 +1,125 @@
+/// @file main.cpp
+/// @brief Scene snapshot and restore benchmark
+///
+/// Demonstrates:
+///   - Registering game object types for serialization
+///   - Adding subclass fields through serialize() and deserialize()
+///   - Saving a scene with save_snapshot() and restoring it with
+///     load_snapshot(), compared against rebuilding it from scratch
+///
+/// Runs headless, nothing is drawn.
+
+#include <asw/asw.h>
+
+#include <chrono>
+
+namespace {
+
+class Enemy : public asw::game::GameObject {
+public:
+    void serialize(asw::serialize::BinaryWriter& writer) const override
+    {
+        GameObject::serialize(writer);
+        writer.write_i32(health);
+        writer.write_vec2(home);
+    }
+
+    void deserialize(asw::serialize::BinaryReader& reader) override
+    {
+        GameObject::deserialize(reader);
+        health = reader.read_i32();
+        home = reader.read_vec2();
+    }
+
+    int health { 100 };
+    asw::Vec2<float> home;
+};
+
+class Pickup : public asw::game::GameObject {
+public:
+    void serialize(asw::serialize::BinaryWriter& writer) const override
+    {
+        GameObject::serialize(writer);
+        writer.write_string(item);
+    }
+
+    void deserialize(asw::serialize::BinaryReader& reader) override
+    {
+        GameObject::deserialize(reader);
+        item = reader.read_string();
+    }
+
+    std::string item { "coin" };
+};
+
+class BenchScene : public asw::scene::Scene<int> {
+public:
+    using asw::scene::Scene<int>::Scene;
+
+    /// @brief Build the level the slow way, one object at a time.
+    void build(int count)
+    {
+        for (int i = 0; i < count; ++i) {
+            const auto x = asw::random::between(0.0F, 4096.0F);
+            const auto y = asw::random::between(0.0F, 4096.0F);
+
+            if (i % 4 == 0) {
+                auto pickup = create_object<Pickup>();
+                pickup->transform = asw::Quad<float>(x, y, 8.0F, 8.0F);
+            } else {
+                auto enemy = create_object<Enemy>();
+                enemy->transform = asw::Quad<float>(x, y, 16.0F, 16.0F);
+                enemy->home = enemy->transform.position;
+                enemy->z_index = i % 3;
+            }
+        }
+
+        update(0.0F);
+    }
+};
+
+template <typename Fn> double time_ms(Fn&& fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+void run(asw::scene::SceneManager<int>& manager, int count)
+{
+    BenchScene scene(manager);
+
+    const auto build_ms = time_ms([&] { scene.build(count); });
+
+    std::vector<uint8_t> snapshot;
+    const auto save_ms = time_ms([&] { snapshot = scene.save_snapshot(); });
+
+    // Play on a little, then restart from the snapshot
+    for (const auto& obj : scene.get_objects()) {
+        obj->transform.position.x += 10.0F;
+    }
+
+    bool restored = false;
+    const auto load_ms = time_ms([&] { restored = scene.load_snapshot(snapshot); });
+
+    asw::log::info("{:>6} objects: build {:>7.2f} ms | save {:>6.2f} ms, load {:>6.2f} ms, "
+                   "{} KiB | restored {}",
+        count, build_ms, save_ms, load_ms, snapshot.size() / 1024, restored);
+}
+
+} // namespace
+
+int main()
+{
+    asw::serialize::register_type<Enemy>("enemy");
+    asw::serialize::register_type<Pickup>("pickup");
+
+    asw::scene::SceneManager<int> manager;
+
+    for (const int count : { 1000, 10000, 100000 }) {
+        run(manager, count);
+    }
+
+    return 0;
+}
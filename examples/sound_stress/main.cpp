@@ -0,0 +1,114 @@
+/// @file main.cpp
+/// @brief Sound play path stress benchmark
+///
+/// Demonstrates:
+///   - Running the sound module headless against SDL's dummy audio driver
+///   - Hammering sound::play() with far more sounds than voices, so most
+///     calls go through voice stealing
+///   - Checking that the play path does not grow memory over time
+///
+/// Exits with a non-zero status if resident memory grows by more than
+/// 1 MiB across the run.
+
+#include <asw/asw.h>
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <numbers>
+#include <vector>
+
+namespace {
+
+constexpr int PLAY_COUNT = 100000;
+constexpr long MAX_GROWTH_KIB = 1024;
+
+/// @brief Resident set size in KiB, or 0 where /proc is not available.
+long resident_kib()
+{
+    std::ifstream statm("/proc/self/statm");
+    long pages = 0;
+    long resident = 0;
+    if (!(statm >> pages >> resident)) {
+        return 0;
+    }
+
+    return resident * 4;
+}
+
+/// @brief Build a short sine blip so the benchmark needs no asset files.
+asw::Sample make_blip()
+{
+    constexpr int freq = 44100;
+    constexpr int frames = freq / 20;
+
+    std::vector<float> data(frames);
+    for (int i = 0; i < frames; ++i) {
+        data[i] = 0.25F * std::sin(2.0F * std::numbers::pi_v<float> * 440.0F * i / freq);
+    }
+
+    SDL_AudioSpec spec;
+    spec.format = SDL_AUDIO_F32;
+    spec.channels = 1;
+    spec.freq = freq;
+
+    auto* audio = MIX_LoadRawAudio(
+        asw::sound::get_mixer(), data.data(), data.size() * sizeof(float), &spec);
+    return { audio, [](MIX_Audio* a) {
+                if (asw::sound::get_mixer() != nullptr) {
+                    MIX_DestroyAudio(a);
+                }
+            } };
+}
+
+} // namespace
+
+int main()
+{
+    SDL_SetHint(SDL_HINT_AUDIO_DRIVER, "dummy");
+
+    if (!SDL_Init(SDL_INIT_AUDIO) || !asw::sound::_init()) {
+        asw::log::error("Failed to initialize audio: {}", SDL_GetError());
+        return 1;
+    }
+
+    const auto blip = make_blip();
+    if (blip == nullptr) {
+        asw::log::error("Failed to create sample: {}", SDL_GetError());
+        return 1;
+    }
+
+    // Warm up so one-off allocations inside SDL are not counted as growth
+    for (int i = 0; i < 1000; ++i) {
+        asw::sound::play(blip, 0.5F, 0.0F, false, i % 4);
+    }
+
+    const long rss_before = resident_kib();
+    const auto start = std::chrono::steady_clock::now();
+
+    int dropped = 0;
+    for (int i = 0; i < PLAY_COUNT; ++i) {
+        const float pan = static_cast<float>(i % 21 - 10) / 10.0F;
+        if (!asw::sound::play(blip, 0.5F, pan, i % 64 == 0, i % 4).is_valid()) {
+            ++dropped;
+        }
+    }
+
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+    const long rss_after = resident_kib();
+    const long growth = rss_after - rss_before;
+
+    asw::log::info("Played {} sounds in {:.3f} ms ({:.1f} ns/play), {} dropped", PLAY_COUNT,
+        elapsed.count() * 1000.0, elapsed.count() * 1e9 / PLAY_COUNT, dropped);
+    asw::log::info("Resident memory: {} KiB -> {} KiB ({:+} KiB)", rss_before, rss_after, growth);
+
+    asw::sound::_shutdown();
+    SDL_Quit();
+
+    if (growth > MAX_GROWTH_KIB) {
+        asw::log::error("Memory grew by {} KiB during the play loop", growth);
+        return 1;
+    }
+
+    return 0;
+}
@@ -10,13 +10,18 @@
 #include "./modules/display.h"
 #include "./modules/draw.h"
 #include "./modules/easing.h"
+#include "./modules/ecs.h"
 #include "./modules/game.h"
 #include "./modules/geometry.h"
 #include "./modules/input.h"
+#include "./modules/jobs.h"
 #include "./modules/log.h"
 #include "./modules/particles.h"
+#include "./modules/physics.h"
 #include "./modules/random.h"
+#include "./modules/replay.h"
 #include "./modules/scene.h"
+#include "./modules/serialize.h"
 #include "./modules/sound.h"
 #include "./modules/types.h"
 #include "./modules/ui/ui.h"
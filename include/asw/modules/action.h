@@ -16,11 +16,23 @@
 ///
 ///   // In game loop:
 ///   if (asw::input::get_action_down("jump")) { /* ... */ }
+///
+///   // Hot paths can hold on to the returned id, or use a compile time name:
+///   const auto jump = asw::input::bind_action("jump", asw::input::KeyBinding{asw::input::Key::W});
+///   if (asw::input::get_action(jump)) { /* ... */ }
+///
+///   using namespace asw::input::literals;
+///   if (asw::input::get_action("jump"_action)) { /* ... */ }
+///
+///   // Group actions so whole sets can be switched off:
+///   asw::input::set_action_set("jump", "gameplay");
+///   asw::input::disable_action_set("gameplay");
 /// @endcode
 
 #ifndef ASW_ACTION_H
 #define ASW_ACTION_H
 
+#include <cstdint>
 #include <string>
 #include <string_view>
 #include <variant>
@@ -60,6 +72,51 @@ struct ControllerAxisBinding {
 using ActionBinding
     = std::variant<KeyBinding, MouseButtonBinding, ControllerButtonBinding, ControllerAxisBinding>;
 
+/// @brief Stable handle to an action. Valid until asw::input::clear_actions().
+struct ActionId {
+    uint32_t index { UINT32_MAX };
+
+    /// @brief Check if the handle refers to an action at all.
+    ///
+    /// @return True if the handle was returned by bind_action or get_action_id.
+    ///
+    bool is_valid() const
+    {
+        return index != UINT32_MAX;
+    }
+};
+
+/// @brief Hash an action name. Matches the hash used by the _action literal.
+///
+/// @param name The action name.
+/// @return The 64 bit FNV-1a hash of the name.
+///
+constexpr uint64_t hash_action_name(std::string_view name)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/// @brief An action name hashed at compile time. Create with the _action literal.
+struct ActionKey {
+    uint64_t hash { 0 };
+};
+
+namespace literals {
+    /// @brief Hash an action name at compile time.
+    ///
+    /// @return The hashed action key.
+    ///
+    consteval ActionKey operator""_action(const char* name, size_t size)
+    {
+        return ActionKey { hash_action_name(std::string_view(name, size)) };
+    }
+} // namespace literals
+
 /// @brief Register a binding for a named action.
 ///
 /// Multiple bindings can be added to the same action; any active binding will
@@ -67,8 +124,23 @@ using ActionBinding
 ///
 /// @param name    The action name.
 /// @param binding The input binding to associate with the action.
+/// @return The id of the action, stable until clear_actions().
+///
+ActionId bind_action(std::string_view name, ActionBinding binding);
+
+/// @brief Look up the id of a named action.
+///
+/// @param name The action name.
+/// @return The action id, or an invalid id if no such action exists.
+///
+ActionId get_action_id(std::string_view name);
+
+/// @brief Look up the id of an action by compile time name.
+///
+/// @param key The hashed action name.
+/// @return The action id, or an invalid id if no such action exists.
 ///
-void bind_action(std::string_view name, ActionBinding binding);
+ActionId get_action_id(ActionKey key);
 
 /// @brief Remove all bindings for a named action.
 ///
@@ -76,10 +148,40 @@ void bind_action(std::string_view name, ActionBinding binding);
 ///
 void unbind_action(std::string_view name);
 
-/// @brief Remove all registered actions and their bindings.
+/// @brief Remove all registered actions and their bindings. Invalidates all action ids.
 ///
 void clear_actions();
 
+/// @brief Assign an action to a named action set.
+///
+/// Actions start in the default set, named "". Actions in a disabled set are
+/// not evaluated and report no input.
+///
+/// @param name The action name.
+/// @param set  The set name, e.g. "menu" or "gameplay".
+///
+void set_action_set(std::string_view name, std::string_view set);
+
+/// @brief Enable an action set.
+///
+/// @param set The set name.
+///
+void enable_action_set(std::string_view set);
+
+/// @brief Disable an action set. Its actions are released and stop being
+/// evaluated until the set is enabled again.
+///
+/// @param set The set name.
+///
+void disable_action_set(std::string_view set);
+
+/// @brief Check if an action set is enabled.
+///
+/// @param set The set name.
+/// @return true if the set is enabled. Unknown sets are enabled.
+///
+bool is_action_set_enabled(std::string_view set);
+
 /// @brief Check if an action was triggered (first pressed) this frame.
 ///
 /// @param name The action name.
@@ -87,6 +189,20 @@ void clear_actions();
 ///
 bool get_action_down(std::string_view name);
 
+/// @brief Check if an action was triggered (first pressed) this frame.
+///
+/// @param id The action id.
+/// @return true if any binding transitioned to active this frame.
+///
+bool get_action_down(ActionId id);
+
+/// @brief Check if an action was triggered (first pressed) this frame.
+///
+/// @param key The hashed action name.
+/// @return true if any binding transitioned to active this frame.
+///
+bool get_action_down(ActionKey key);
+
 /// @brief Check if an action was released this frame.
 ///
 /// @param name The action name.
@@ -94,6 +210,20 @@ bool get_action_down(std::string_view name);
 ///
 bool get_action_up(std::string_view name);
 
+/// @brief Check if an action was released this frame.
+///
+/// @param id The action id.
+/// @return true if any binding transitioned to inactive this frame.
+///
+bool get_action_up(ActionId id);
+
+/// @brief Check if an action was released this frame.
+///
+/// @param key The hashed action name.
+/// @return true if any binding transitioned to inactive this frame.
+///
+bool get_action_up(ActionKey key);
+
 /// @brief Check if an action is currently held down.
 ///
 /// @param name The action name.
@@ -101,6 +231,20 @@ bool get_action_up(std::string_view name);
 ///
 bool get_action(std::string_view name);
 
+/// @brief Check if an action is currently held down.
+///
+/// @param id The action id.
+/// @return true if any binding is currently active.
+///
+bool get_action(ActionId id);
+
+/// @brief Check if an action is currently held down.
+///
+/// @param key The hashed action name.
+/// @return true if any binding is currently active.
+///
+bool get_action(ActionKey key);
+
 /// @brief Get the analogue strength of an action (0.0 – 1.0).
 ///
 /// For button/key bindings this is 0 or 1. For axis bindings it is the
@@ -112,13 +256,43 @@ bool get_action(std::string_view name);
 ///
 float get_action_strength(std::string_view name);
 
+/// @brief Get the analogue strength of an action (0.0 – 1.0).
+///
+/// @param id The action id.
+/// @return float Strength in [0.0, 1.0].
+///
+float get_action_strength(ActionId id);
+
+/// @brief Get the analogue strength of an action (0.0 – 1.0).
+///
+/// @param key The hashed action name.
+/// @return float Strength in [0.0, 1.0].
+///
+float get_action_strength(ActionKey key);
+
 /// @brief Update cached action states from current raw input.
 ///
-/// Called automatically by asw::input::reset() — you do not need to call
-/// this yourself unless you are managing the input loop manually.
+/// Only actions bound to an input that changed since the last update are
+/// re-evaluated. Called automatically by asw::input::reset() — you do not
+/// need to call this yourself unless you are managing the input loop manually.
 ///
 void update_actions();
 
+/// @brief Key changed hook
+void _action_key_changed(SDL_Scancode scancode);
+
+/// @brief Mouse button changed hook
+void _action_mouse_button_changed(uint8_t button);
+
+/// @brief Controller button changed hook
+void _action_controller_button_changed(uint32_t index, uint32_t button);
+
+/// @brief Controller axis changed hook
+void _action_controller_axis_changed(uint32_t index, uint32_t axis);
+
+/// @brief Controller connected or disconnected hook
+void _action_controllers_changed();
+
 } // namespace asw::input
 
 #endif // ASW_ACTION_H
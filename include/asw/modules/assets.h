@@ -9,6 +9,7 @@
 #ifndef ASW_ASSETS_H
 #define ASW_ASSETS_H
 
+#include <future>
 #include <string>
 
 #include "./types.h"
@@ -149,6 +150,22 @@ asw::Music load_music(const std::string& filename);
 ///
 asw::Music load_music(const std::string& filename, const std::string& key);
 
+/// @brief Load a music file on a background thread.
+///
+/// @details Opening and probing a stream can take long enough to hitch a
+/// frame, so this moves it onto a background loader thread. It is kept apart
+/// from the job system, so waiting on jobs never runs a load inline. Unlike
+/// load_music(), a missing file does not abort; the future yields nullptr
+/// instead. Dropping the future does not wait for the load, the music is
+/// released once it finishes.
+///
+/// @param filename The path to the music file.
+/// @param predecode Decode the whole file up front, so it loops without
+/// re-seeking the stream.
+/// @return Future for the loaded Music object.
+///
+std::future<asw::Music> load_music_async(const std::string& filename, bool predecode = false);
+
 /// @brief Get a cached music.
 ///
 /// @param key The key of the cached music.
@@ -169,6 +186,11 @@ void unload_music(const std::string& key);
 ///
 void clear_all();
 
+/// @brief Shut down the assets module. Called by asw::core::shutdown().
+/// Finishes queued background loads, then stops the loader thread.
+///
+void _shutdown();
+
 } // namespace asw::assets
 
 #endif // ASW_ASSETS_H
@@ -9,12 +9,37 @@
 #ifndef ASW_CORE_H
 #define ASW_CORE_H
 
+#include <cstdint>
+
 namespace asw::core {
 
 /// @brief Updates core module functionality.
 ///
 void update();
 
+/// @brief Updates core module functionality, consuming only input that
+/// happened up to a point in time. Later input is kept for the next update, so
+/// fixed ticks each see the input from their own slice of time.
+///
+/// @param end_ns End of the time slice, in SDL_GetTicksNS() time.
+///
+void update_until(uint64_t end_ns);
+
+/// @brief Get the end of the time slice of the last update. Compare with
+/// input timestamps for sub-tick timing.
+///
+/// @return The time in SDL_GetTicksNS() time.
+///
+uint64_t get_tick_time();
+
+/// @brief Wait until a point in time. Sleeps while the OS scheduler can be
+/// trusted to wake up in time, then spins for the remainder, so the deadline
+/// is met closely without burning a core for the whole wait.
+///
+/// @param deadline_ns The time to wake at, in SDL_GetTicksNS() time.
+///
+void sleep_until(uint64_t deadline_ns);
+
 /// @brief Initializes the core module.
 ///
 /// @param width The width of the window.
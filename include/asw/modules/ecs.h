@@ -0,0 +1,608 @@
+/// @file ecs.h
+/// @author Allan Legemaate (alegemaate@gmail.com)
+/// @brief Data oriented entity component system
+/// @date 2026-10-18
+///
+/// @copyright Copyright (c) 2026
+///
+/// Entities are plain ids. Each component type is stored densely in its own
+/// sparse set, so systems walk contiguous arrays instead of chasing one heap
+/// block per object. Every scene owns a World, which is updated and drawn
+/// after the scene's game objects, so both styles can live side by side.
+///
+/// Example:
+/// @code
+///   auto& world = get_world();
+///   world.add_system(asw::ecs::physics_system);
+///   world.add_draw_system(asw::ecs::sprite_system);
+///
+///   const auto e = world.create();
+///   world.emplace<asw::ecs::Transform>(e, asw::Quad<float>(0, 0, 16, 16));
+///   world.emplace<asw::ecs::Physics>(e).velocity = { 10.0F, 0.0F };
+///   world.emplace<asw::ecs::Sprite>(e, texture);
+///
+///   world.view<asw::ecs::Transform, asw::ecs::Physics>().each(
+///       [](asw::ecs::Entity, auto& transform, auto& body) { ... });
+/// @endcode
+
+#ifndef ASW_ECS_H
+#define ASW_ECS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
+#include "./draw.h"
+#include "./game.h"
+#include "./geometry.h"
+#include "./types.h"
+
+namespace asw::ecs {
+
+/// @brief Handle to an entity. The generation detects stale handles after an
+/// entity is destroyed and its index reused.
+struct Entity {
+    uint32_t index { UINT32_MAX };
+    uint32_t generation { 0 };
+
+    /// @brief Check if the handle refers to an entity at all.
+    ///
+    /// @return True if the handle was returned by World::create().
+    ///
+    bool is_valid() const
+    {
+        return index != UINT32_MAX;
+    }
+
+    bool operator==(const Entity& other) const = default;
+};
+
+/// Components
+///
+
+/// @brief Position, size and rotation of an entity.
+///
+struct Transform {
+    asw::Quad<float> quad;
+
+    // Rotation in radians
+    float rotation { 0.0F };
+};
+
+/// @brief Velocity and acceleration of an entity, shared with game objects.
+///
+using Physics = asw::game::Physics;
+
+/// @brief Texture drawn at the entity's transform.
+///
+struct Sprite {
+    asw::Texture texture;
+
+    // Draw order, higher is drawn on top
+    int z_index { 0 };
+
+    // Opacity
+    float alpha { 1.0F };
+};
+
+/// Storage
+///
+
+/// @brief Type erased base of a component pool, so the world can remove an
+/// entity from every pool without knowing their types.
+///
+class PoolBase {
+public:
+    virtual ~PoolBase() = default;
+
+    /// @brief Remove the entity's component, if it has one.
+    ///
+    /// @param entity The entity index.
+    ///
+    virtual void remove(uint32_t entity) = 0;
+
+    /// @brief Remove every component.
+    ///
+    virtual void clear() = 0;
+};
+
+/// @brief Sparse set of one component type. Components and their owners are
+/// kept in two parallel dense arrays, with a sparse array mapping entity index
+/// to dense position. Removal swaps the last element into the hole.
+///
+/// @tparam C The component type.
+///
+template <typename C> class Pool : public PoolBase {
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    bool contains(uint32_t entity) const
+    {
+        return entity < sparse_.size() && sparse_[entity] != NONE;
+    }
+
+    template <typename... Args> C& emplace(uint32_t entity, Args&&... args)
+    {
+        if (contains(entity)) {
+            return components_[sparse_[entity]] = C { std::forward<Args>(args)... };
+        }
+
+        if (entity >= sparse_.size()) {
+            sparse_.resize(entity + 1, NONE);
+        }
+
+        sparse_[entity] = static_cast<uint32_t>(entities_.size());
+        entities_.push_back(entity);
+        components_.push_back(C { std::forward<Args>(args)... });
+        return components_.back();
+    }
+
+    C& get(uint32_t entity)
+    {
+        return components_[sparse_[entity]];
+    }
+
+    C* try_get(uint32_t entity)
+    {
+        return contains(entity) ? &components_[sparse_[entity]] : nullptr;
+    }
+
+    void remove(uint32_t entity) override
+    {
+        if (!contains(entity)) {
+            return;
+        }
+
+        const auto hole = sparse_[entity];
+        const auto last = entities_.back();
+
+        if (hole != entities_.size() - 1) {
+            entities_[hole] = last;
+            components_[hole] = std::move(components_.back());
+            sparse_[last] = hole;
+        }
+
+        entities_.pop_back();
+        components_.pop_back();
+        sparse_[entity] = NONE;
+    }
+
+    void clear() override
+    {
+        sparse_.clear();
+        entities_.clear();
+        components_.clear();
+    }
+
+    /// @brief Sort the dense arrays, so views over this pool visit components
+    /// in order. Already sorted pools are left alone.
+    ///
+    /// @param compare Strict weak ordering of two components.
+    ///
+    template <typename Compare> void sort(Compare compare)
+    {
+        if (std::is_sorted(components_.begin(), components_.end(), compare)) {
+            return;
+        }
+
+        order_.resize(components_.size());
+        std::iota(order_.begin(), order_.end(), 0U);
+        std::stable_sort(order_.begin(), order_.end(),
+            [&](uint32_t a, uint32_t b) { return compare(components_[a], components_[b]); });
+
+        // Apply the permutation cycle by cycle, so no second copy is needed
+        for (uint32_t i = 0; i < order_.size(); ++i) {
+            auto current = i;
+            auto next = order_[current];
+
+            while (next != i) {
+                std::swap(components_[current], components_[next]);
+                std::swap(entities_[current], entities_[next]);
+                order_[current] = current;
+                current = next;
+                next = order_[current];
+            }
+
+            order_[current] = current;
+        }
+
+        for (uint32_t i = 0; i < entities_.size(); ++i) {
+            sparse_[entities_[i]] = i;
+        }
+    }
+
+    size_t size() const
+    {
+        return entities_.size();
+    }
+
+    const std::vector<uint32_t>& entities() const
+    {
+        return entities_;
+    }
+
+    std::vector<C>& components()
+    {
+        return components_;
+    }
+
+private:
+    std::vector<uint32_t> sparse_;
+    std::vector<uint32_t> entities_;
+    std::vector<C> components_;
+    std::vector<uint32_t> order_;
+};
+
+class World;
+
+/// @brief Typed view over every entity that has all of the given components.
+/// Iterates the smallest pool and skips entities missing from the others.
+///
+/// @tparam Cs The component types.
+///
+template <typename... Cs> class View {
+public:
+    explicit View(World& world);
+
+    /// @brief Call a function for every matching entity.
+    ///
+    /// @param fn Called as fn(Entity, Cs&...).
+    ///
+    template <typename Fn> void each(Fn&& fn);
+
+private:
+    World& world_;
+    std::tuple<Pool<Cs>*...> pools_;
+};
+
+/// @brief A system run by the world each update.
+using System = std::function<void(World&, float)>;
+
+/// @brief A system run by the world each draw.
+using DrawSystem = std::function<void(World&)>;
+
+/// @brief Owns entities, their components and the systems that run on them.
+///
+class World {
+public:
+    /// @brief Create an entity.
+    ///
+    /// @return The new entity.
+    ///
+    Entity create()
+    {
+        if (!free_.empty()) {
+            const auto index = free_.back();
+            free_.pop_back();
+            return { index, generations_[index] };
+        }
+
+        generations_.push_back(1);
+        return { static_cast<uint32_t>(generations_.size() - 1), 1 };
+    }
+
+    /// @brief Destroy an entity at the end of the current update, so systems
+    /// can destroy entities while iterating.
+    ///
+    /// @param entity The entity to destroy.
+    ///
+    void destroy(Entity entity)
+    {
+        if (is_alive(entity)) {
+            pending_destroy_.push_back(entity);
+        }
+    }
+
+    /// @brief Check if an entity exists.
+    ///
+    /// @param entity The entity to check.
+    /// @return True if the entity has not been destroyed.
+    ///
+    bool is_alive(Entity entity) const
+    {
+        return entity.index < generations_.size()
+            && generations_[entity.index] == entity.generation;
+    }
+
+    /// @brief Get the handle of a live entity from its index.
+    ///
+    /// @param index The entity index.
+    /// @return The entity handle.
+    ///
+    Entity handle(uint32_t index) const
+    {
+        return { index, generations_[index] };
+    }
+
+    /// @brief Get the number of live entities.
+    ///
+    /// @return The entity count.
+    ///
+    size_t size() const
+    {
+        return generations_.size() - free_.size();
+    }
+
+    /// @brief Add or replace a component on an entity.
+    ///
+    /// @param entity The entity.
+    /// @param args Arguments forwarded to the component.
+    /// @return Reference to the component.
+    ///
+    template <typename C, typename... Args> C& emplace(Entity entity, Args&&... args)
+    {
+        return pool<C>().emplace(entity.index, std::forward<Args>(args)...);
+    }
+
+    /// @brief Get a component of an entity. The entity must have it.
+    ///
+    /// @param entity The entity.
+    /// @return Reference to the component.
+    ///
+    template <typename C> C& get(Entity entity)
+    {
+        return pool<C>().get(entity.index);
+    }
+
+    /// @brief Get a component of an entity if it has one.
+    ///
+    /// @param entity The entity.
+    /// @return Pointer to the component, or nullptr.
+    ///
+    template <typename C> C* try_get(Entity entity)
+    {
+        return is_alive(entity) ? pool<C>().try_get(entity.index) : nullptr;
+    }
+
+    /// @brief Check if an entity has a component.
+    ///
+    /// @param entity The entity.
+    /// @return True if the entity has the component.
+    ///
+    template <typename C> bool has(Entity entity)
+    {
+        return is_alive(entity) && pool<C>().contains(entity.index);
+    }
+
+    /// @brief Remove a component from an entity.
+    ///
+    /// @param entity The entity.
+    ///
+    template <typename C> void remove(Entity entity)
+    {
+        pool<C>().remove(entity.index);
+    }
+
+    /// @brief Get the storage of a component type.
+    ///
+    /// @return The component pool.
+    ///
+    template <typename C> Pool<C>& pool()
+    {
+        const auto id = component_id<C>();
+        if (id >= pools_.size()) {
+            pools_.resize(id + 1);
+        }
+
+        if (pools_[id] == nullptr) {
+            pools_[id] = std::make_unique<Pool<C>>();
+        }
+
+        return static_cast<Pool<C>&>(*pools_[id]);
+    }
+
+    /// @brief Get a view of every entity with all of the given components.
+    ///
+    /// @return The view.
+    ///
+    template <typename... Cs> View<Cs...> view()
+    {
+        return View<Cs...>(*this);
+    }
+
+    /// @brief Add a system to run every update, in the order added.
+    ///
+    /// @param system The system.
+    ///
+    void add_system(System system)
+    {
+        systems_.push_back(std::move(system));
+    }
+
+    /// @brief Add a system to run every draw, in the order added.
+    ///
+    /// @param system The system.
+    ///
+    void add_draw_system(DrawSystem system)
+    {
+        draw_systems_.push_back(std::move(system));
+    }
+
+    /// @brief Remove every system.
+    ///
+    void clear_systems()
+    {
+        systems_.clear();
+        draw_systems_.clear();
+    }
+
+    /// @brief Run the update systems, then apply pending destroys.
+    ///
+    /// @param dt The time in seconds since the last update.
+    ///
+    void update(float dt)
+    {
+        for (auto& system : systems_) {
+            system(*this, dt);
+        }
+
+        flush();
+    }
+
+    /// @brief Run the draw systems.
+    ///
+    void draw()
+    {
+        for (auto& system : draw_systems_) {
+            system(*this);
+        }
+    }
+
+    /// @brief Apply pending destroys now.
+    ///
+    void flush()
+    {
+        for (const auto entity : pending_destroy_) {
+            if (!is_alive(entity)) {
+                continue;
+            }
+
+            for (auto& p : pools_) {
+                if (p != nullptr) {
+                    p->remove(entity.index);
+                }
+            }
+
+            ++generations_[entity.index];
+            free_.push_back(entity.index);
+        }
+
+        pending_destroy_.clear();
+    }
+
+    /// @brief Destroy every entity. Systems are kept.
+    ///
+    void clear()
+    {
+        for (auto& p : pools_) {
+            if (p != nullptr) {
+                p->clear();
+            }
+        }
+
+        // Bump generations so old handles stay stale
+        free_.clear();
+        for (uint32_t i = 0; i < generations_.size(); ++i) {
+            ++generations_[i];
+            free_.push_back(i);
+        }
+
+        pending_destroy_.clear();
+    }
+
+private:
+    /// @brief Dense id per component type, assigned on first use.
+    static inline size_t next_component_id_ = 0;
+
+    template <typename C> static size_t component_id()
+    {
+        static const size_t id = next_component_id_++;
+        return id;
+    }
+
+    std::vector<std::unique_ptr<PoolBase>> pools_;
+    std::vector<uint32_t> generations_;
+    std::vector<uint32_t> free_;
+    std::vector<Entity> pending_destroy_;
+
+    std::vector<System> systems_;
+    std::vector<DrawSystem> draw_systems_;
+};
+
+template <typename... Cs>
+View<Cs...>::View(World& world)
+    : world_(world)
+    , pools_(&world.pool<Cs>()...)
+{
+}
+
+template <typename... Cs> template <typename Fn> void View<Cs...>::each(Fn&& fn)
+{
+    // Drive iteration from the smallest pool
+    const std::vector<uint32_t>* smallest = nullptr;
+    std::apply(
+        [&smallest](auto*... pool) {
+            ((smallest = (smallest == nullptr || pool->size() < smallest->size())
+                      ? &pool->entities()
+                      : smallest),
+                ...);
+        },
+        pools_);
+
+    // Indexed loop, so components added by fn during iteration are safe
+    for (size_t i = 0; i < smallest->size(); ++i) {
+        const auto index = (*smallest)[i];
+
+        const bool matches
+            = std::apply([index](auto*... pool) { return (pool->contains(index) && ...); }, pools_);
+
+        if (matches) {
+            std::apply(
+                [&](auto*... pool) { fn(world_.handle(index), pool->get(index)...); }, pools_);
+        }
+    }
+}
+
+/// Systems
+///
+
+/// @brief Integrate Physics into Transform, the same way GameObject::update does.
+///
+/// @param world The world.
+/// @param dt The time in seconds since the last update.
+///
+inline void physics_system(World& world, float dt)
+{
+    world.view<Transform, Physics>().each([dt](Entity, Transform& transform, Physics& body) {
+        body.velocity += body.acceleration * dt;
+        transform.quad.position += body.velocity * dt;
+        body.angular_velocity += body.angular_acceleration * dt;
+        transform.rotation += body.angular_velocity * dt;
+    });
+}
+
+/// @brief Draw every entity with a Transform and Sprite, ordered by z index.
+///
+/// @param world The world.
+///
+inline void sprite_system(World& world)
+{
+    auto& sprites = world.pool<Sprite>();
+    auto& transforms = world.pool<Transform>();
+
+    sprites.sort([](const Sprite& a, const Sprite& b) { return a.z_index < b.z_index; });
+
+    // Walk the sprite pool directly, a view may iterate in transform order
+    const auto& entities = sprites.entities();
+    auto& components = sprites.components();
+
+    for (size_t i = 0; i < entities.size(); ++i) {
+        auto& sprite = components[i];
+        const auto* transform = transforms.try_get(entities[i]);
+        if (transform == nullptr || sprite.texture == nullptr) {
+            continue;
+        }
+
+        if (sprite.alpha < 1.0F) {
+            asw::draw::set_alpha(sprite.texture, sprite.alpha);
+        }
+
+        if (transform->rotation != 0.0F) {
+            asw::draw::rotate_sprite(sprite.texture, transform->quad.position, transform->rotation);
+        } else {
+            asw::draw::stretch_sprite(sprite.texture, transform->quad);
+        }
+
+        if (sprite.alpha < 1.0F) {
+            asw::draw::set_alpha(sprite.texture, 1.0F);
+        }
+    }
+}
+
+} // namespace asw::ecs
+
+#endif // ASW_ECS_H
@@ -9,13 +9,20 @@
 #ifndef ASW_COMPONENTS_H
 #define ASW_COMPONENTS_H
 
+#include <cstdint>
 #include <string>
 
+#include "./assets.h"
 #include "./color.h"
 #include "./draw.h"
 #include "./geometry.h"
+#include "./serialize.h"
 #include "./util.h"
 
+namespace asw::scene {
+template <typename T> class Scene;
+} // namespace asw::scene
+
 namespace asw::game {
 /// Components
 ///
@@ -63,6 +70,66 @@ public:
         // Do nothing by default
     };
 
+    /// @brief Write the object's state. Override to add subclass fields,
+    /// calling the base class first.
+    ///
+    /// @param writer The writer.
+    ///
+    virtual void serialize(serialize::BinaryWriter& writer) const
+    {
+        writer.write_quad(transform);
+        writer.write_f32(rotation);
+        writer.write_i32(z_index);
+        writer.write_bool(active);
+        writer.write_bool(alive);
+        writer.write_f32(alpha);
+        writer.write_vec2(body.velocity);
+        writer.write_vec2(body.acceleration);
+        writer.write_f32(body.angular_velocity);
+        writer.write_f32(body.angular_acceleration);
+        writer.write_u32(collision_layer);
+        writer.write_u32(collision_mask);
+    }
+
+    /// @brief Read the state written by serialize(), in the same order.
+    ///
+    /// @param reader The reader.
+    ///
+    virtual void deserialize(serialize::BinaryReader& reader)
+    {
+        transform = reader.read_quad();
+        rotation = reader.read_f32();
+        z_index = reader.read_i32();
+        active = reader.read_bool();
+        alive = reader.read_bool();
+        alpha = reader.read_f32();
+        body.velocity = reader.read_vec2();
+        body.acceleration = reader.read_vec2();
+        body.angular_velocity = reader.read_f32();
+        body.angular_acceleration = reader.read_f32();
+        collision_layer = reader.read_u32();
+        collision_mask = reader.read_u32();
+    }
+
+    /// @brief Make the previous tick's state match the current one, so the
+    /// next draw does not blend from the old state. Call after teleporting.
+    ///
+    void reset_interpolation()
+    {
+        prev_transform = transform;
+        prev_rotation = rotation;
+    }
+
+    /// @brief Texture the object draws with, so scenes can group objects that
+    /// share one and let the renderer batch them.
+    ///
+    /// @return The texture, or nullptr if the object does not draw one.
+    ///
+    virtual SDL_Texture* get_batch_texture() const
+    {
+        return nullptr;
+    }
+
     /// @brief Get transform
     ///
     /// @return The position of the object.
@@ -80,6 +147,20 @@ public:
     ///
     float rotation { 0.0F };
 
+    /// @brief The transform at the start of the last update.
+    /// @details Scenes draw objects blended between this and transform, by how
+    /// far the frame is into the next fixed update.
+    ///
+    asw::Quad<float> prev_transform;
+
+    /// @brief The rotation at the start of the last update.
+    ///
+    float prev_rotation { 0.0F };
+
+    /// @brief Whether the object is drawn at its interpolated state.
+    ///
+    bool interpolate { true };
+
     /// @brief The layer that the object is on.
     /// @details Objects on higher layers are drawn on top of objects on lower
     /// layers.
@@ -102,9 +183,44 @@ public:
     /// @brief Alive state
     ///
     bool alive { true };
+
+    /// @brief Collision layers the object is on, one bit per layer.
+    ///
+    uint32_t collision_layer { 1 };
+
+    /// @brief Collision layers the object collides with.
+    ///
+    uint32_t collision_mask { UINT32_MAX };
+
+    /// @brief Whether the object can be updated on a worker thread.
+    /// @details Set this, usually from the constructor of a type, when update
+    /// only touches the object's own state. It may still call the scene's
+    /// create_object, and read its object views and broadphase. Thread safe
+    /// objects are updated in parallel before the rest of the scene.
+    ///
+    bool thread_safe { false };
+
+private:
+    template <typename T> friend class asw::scene::Scene;
+
+    /// @brief Where a scene keeps the object in its draw order.
+    struct DrawSlot {
+        // The z index the object is filed under
+        int layer { 0 };
+
+        // Position within that layer, UINT32_MAX when not filed
+        uint32_t index { UINT32_MAX };
+    };
+
+    /// @brief Draw order bookkeeping, managed by the scene.
+    ///
+    DrawSlot _draw_slot;
 };
 
 /// @brief Sprite Object
+/// @details Snapshots restore the texture only when it was set by key. Sprites
+/// are not registered for snapshots, register Sprite or a subclass to have
+/// them saved.
 ///
 class Sprite : public GameObject {
 public:
@@ -117,12 +233,51 @@ public:
     void set_texture(const asw::Texture& texture, bool auto_size = true)
     {
         this->texture_ = texture;
+        this->texture_key_.clear();
 
         if (auto_size) {
             transform.size = asw::util::get_texture_size(texture_);
         }
     }
 
+    /// @brief Set the texture of the sprite to one loaded with a key.
+    /// Snapshots store the key, so the texture comes back when they load.
+    ///
+    /// @param key The key the texture was loaded with.
+    /// @param auto_size Whether or not to automatically set the size of the
+    /// sprite based on the texture dimensions.
+    ///
+    void set_texture_key(const std::string& key, bool auto_size = true)
+    {
+        set_texture(asw::assets::get_texture(key), auto_size);
+        this->texture_key_ = key;
+    }
+
+    /// @brief Write the sprite's state and the key of its texture.
+    ///
+    /// @param writer The writer.
+    ///
+    void serialize(serialize::BinaryWriter& writer) const override
+    {
+        GameObject::serialize(writer);
+        writer.write_string(texture_key_);
+    }
+
+    /// @brief Read the state written by serialize(). A texture set without a
+    /// key is not stored, so the current one is kept.
+    ///
+    /// @param reader The reader.
+    ///
+    void deserialize(serialize::BinaryReader& reader) override
+    {
+        GameObject::deserialize(reader);
+
+        if (auto key = reader.read_string(); !key.empty()) {
+            texture_ = asw::assets::get_texture(key);
+            texture_key_ = std::move(key);
+        }
+    }
+
     /// @brief Draw the sprite to the screen.
     /// @details If a rotation is set, the sprite will be rotated around its
     /// center.
@@ -148,13 +303,29 @@ public:
         }
     }
 
+    /// @brief Get the texture to batch the sprite by.
+    ///
+    /// @return The sprite's texture.
+    ///
+    SDL_Texture* get_batch_texture() const override
+    {
+        return texture_.get();
+    }
+
 private:
     /// @brief The texture of the sprite.
     ///
     asw::Texture texture_;
+
+    /// @brief Key the texture was loaded with, empty if set directly.
+    ///
+    std::string texture_key_;
 };
 
 /// @brief Text Object
+/// @details Snapshots restore the font only when it was set by key. Texts are
+/// not registered for snapshots, register Text or a subclass to have them
+/// saved.
 ///
 class Text : public GameObject {
 public:
@@ -165,6 +336,18 @@ public:
     void set_font(const asw::Font& font)
     {
         this->font_ = font;
+        this->font_key_.clear();
+    }
+
+    /// @brief Set the font of the text to one loaded with a key. Snapshots
+    /// store the key, so the font comes back when they load.
+    ///
+    /// @param key The key the font was loaded with.
+    ///
+    void set_font_key(const std::string& key)
+    {
+        this->font_ = asw::assets::get_font(key);
+        this->font_key_ = key;
     }
 
     /// @brief Set the text of the text object.
@@ -201,9 +384,47 @@ public:
         asw::draw::text(font_, text_, transform.position, color_, justify_);
     }
 
+    /// @brief Write the text's state, including the key of its font.
+    ///
+    /// @param writer The writer.
+    ///
+    void serialize(serialize::BinaryWriter& writer) const override
+    {
+        GameObject::serialize(writer);
+        writer.write_string(text_);
+        writer.write_u8(color_.r);
+        writer.write_u8(color_.g);
+        writer.write_u8(color_.b);
+        writer.write_u8(color_.a);
+        writer.write_u8(static_cast<uint8_t>(justify_));
+        writer.write_string(font_key_);
+    }
+
+    /// @brief Read the state written by serialize(). A font set without a key
+    /// is not stored, so the current one is kept.
+    ///
+    /// @param reader The reader.
+    ///
+    void deserialize(serialize::BinaryReader& reader) override
+    {
+        GameObject::deserialize(reader);
+        text_ = reader.read_string();
+        color_.r = reader.read_u8();
+        color_.g = reader.read_u8();
+        color_.b = reader.read_u8();
+        color_.a = reader.read_u8();
+        justify_ = static_cast<asw::TextJustify>(reader.read_u8());
+
+        if (auto key = reader.read_string(); !key.empty()) {
+            font_ = asw::assets::get_font(key);
+            font_key_ = std::move(key);
+        }
+    }
+
 private:
     std::string text_;
     asw::Font font_;
+    std::string font_key_;
     asw::Color color_;
     asw::TextJustify justify_ { asw::TextJustify::Left };
 };
@@ -11,6 +11,8 @@
 
 #include <SDL3/SDL.h>
 #include <array>
+#include <bitset>
+#include <initializer_list>
 #include <string>
 
 #include "./geometry.h"
@@ -300,6 +302,12 @@ enum class CursorId {
     NumCursors = NUM_CURSORS
 };
 
+/// @brief Packed set of mouse buttons, one bit per button.
+using MouseButtonSet = std::bitset<NUM_MOUSE_BUTTONS>;
+
+/// @brief Packed set of keys, one bit per scancode.
+using KeySet = std::bitset<NUM_KEYS>;
+
 /// @brief Mouse state stores the current state of the mouse. It is updated by
 /// the core.
 using MouseState = struct MouseState {
@@ -310,9 +318,12 @@ using MouseState = struct MouseState {
     Vec2<float> position { 0.0F, 0.0F };
     float z { 0.0F };
 
-    std::array<bool, NUM_MOUSE_BUTTONS> pressed { false };
-    std::array<bool, NUM_MOUSE_BUTTONS> released { false };
-    std::array<bool, NUM_MOUSE_BUTTONS> down { false };
+    /// @brief When the last button was pressed, in SDL_GetTicksNS() time.
+    uint64_t last_pressed_time { 0 };
+
+    MouseButtonSet pressed;
+    MouseButtonSet released;
+    MouseButtonSet down;
 };
 
 /// @brief Get the current mouse state.
@@ -345,16 +356,51 @@ bool get_mouse_button_down(asw::input::MouseButton button);
 ///
 bool get_mouse_button_up(asw::input::MouseButton button);
 
+/// @brief A raw mouse position sample, taken from a single motion event.
+struct MouseSample {
+    Vec2<float> position { 0.0F, 0.0F };
+    uint64_t timestamp { 0 };
+};
+
+/// @brief Keep the raw mouse positions seen during each update, for drawing
+/// or aim smoothing. Motion is otherwise coalesced into one update per frame.
+///
+/// @param capacity Maximum samples kept per update, the newest win. 0 disables sampling.
+///
+void set_mouse_sample_capacity(size_t capacity);
+
+/// @brief Get the mouse sample capacity.
+///
+/// @return The capacity, 0 if sampling is disabled.
+///
+size_t get_mouse_sample_capacity();
+
+/// @brief Get the number of mouse samples taken during the last update.
+///
+/// @return The sample count.
+///
+size_t get_mouse_sample_count();
+
+/// @brief Get a mouse sample from the last update, oldest first.
+///
+/// @param index The sample index, less than get_mouse_sample_count().
+/// @return The sample.
+///
+MouseSample get_mouse_sample(size_t index);
+
 /// @brief Keyboard state stores the current state of the keyboard. It is
 /// updated by the core.
 ///
 using KeyState = struct KeyState {
-    std::array<bool, NUM_KEYS> pressed { false };
-    std::array<bool, NUM_KEYS> released { false };
-    std::array<bool, NUM_KEYS> down { false };
+    KeySet pressed;
+    KeySet released;
+    KeySet down;
 
     bool any_pressed { false };
     int last_pressed { -1 };
+
+    /// @brief When the last key was pressed, in SDL_GetTicksNS() time.
+    uint64_t last_pressed_time { 0 };
 };
 
 /// @brief Get the current keyboard state.
@@ -387,6 +433,37 @@ bool get_key_down(asw::input::Key key);
 ///
 bool get_key_up(asw::input::Key key);
 
+/// @brief Build a key set for the bulk key queries.
+///
+/// @param keys The keys to include.
+/// @return The packed key set.
+///
+KeySet make_key_set(std::initializer_list<asw::input::Key> keys);
+
+/// @brief Check if any key in a set is down.
+///
+/// @details Tests the whole set a machine word at a time, so build the set
+/// once and reuse it.
+///
+/// @param keys The keys to check.
+/// @return true - If at least one of the keys is down.
+///
+bool get_any_key(const KeySet& keys);
+
+/// @brief Check if any key in a set was pressed since the last update.
+///
+/// @param keys The keys to check.
+/// @return true - If at least one of the keys was pressed.
+///
+bool get_any_key_down(const KeySet& keys);
+
+/// @brief Check if any key in a set was released since the last update.
+///
+/// @param keys The keys to check.
+/// @return true - If at least one of the keys was released.
+///
+bool get_any_key_up(const KeySet& keys);
+
 /// @brief Change cursor
 ///
 /// @param cursor The cursor to change to.
@@ -396,9 +473,16 @@ bool get_key_up(asw::input::Key key);
 ///
 void set_cursor(asw::input::CursorId cursor);
 
+/// @brief Maximum number of controllers connected at once. Each one keeps its
+/// index (player slot) until it is disconnected.
+constexpr uint32_t MAX_CONTROLLERS = 8;
+
 /// @brief Number of buttons on a game controller
 constexpr int NUM_CONTROLLER_BUTTONS = SDL_GAMEPAD_BUTTON_COUNT;
 
+/// @brief Packed set of controller buttons, one bit per button.
+using ControllerButtonSet = std::bitset<NUM_CONTROLLER_BUTTONS>;
+
 /// @brief Mappings from SDL game controller buttons to ASW buttons
 enum class ControllerButton {
     A = SDL_GAMEPAD_BUTTON_SOUTH,
@@ -476,6 +560,14 @@ void set_controller_dead_zone(uint32_t index, float dead_zone);
 /// @brief Get the number of controllers connected.
 int get_controller_count();
 
+/// @brief Check if a controller slot has a controller connected. Slots are not
+/// compacted, so indices may have gaps after a disconnect.
+///
+/// @param index The index of the controller to check.
+/// @return true if a controller is connected in the slot.
+///
+bool is_controller_connected(uint32_t index);
+
 /// @brief Get the name of a controller.
 std::string get_controller_name(uint32_t index);
 
@@ -493,6 +585,9 @@ void reset();
 /// @brief Append text to this frame's text input. Called by the core.
 void _append_text(const char* text);
 
+/// @brief Event time hook, sets the time of the events that follow
+void _event_time(uint64_t timestamp);
+
 /// @brief Key down hook
 void _key_down(SDL_Scancode scancode);
 
@@ -508,12 +603,18 @@ void _mouse_button_up(uint8_t button);
 /// @brief Mouse motion hook
 void _mouse_motion(float x, float y, float delta_x, float delta_y);
 
+/// @brief Mouse sample hook
+void _mouse_sample(float x, float y, uint64_t timestamp);
+
 /// @brief Mouse wheel hook
 void _mouse_wheel(float delta_z);
 
 /// @brief Controller added hook
 void _controller_added(SDL_JoystickID id);
 
+/// @brief Controller added hook for replays, registers the id without opening a device
+void _virtual_controller_added(SDL_JoystickID id);
+
 /// @brief Controller removed hook
 void _controller_removed(SDL_JoystickID id);
 
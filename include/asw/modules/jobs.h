@@ -0,0 +1,165 @@
+/// @file jobs.h
+/// @author Allan Legemaate (alegemaate@gmail.com)
+/// @brief Work stealing job system
+/// @date 2026-10-18
+///
+/// @copyright Copyright (c) 2026
+///
+/// A fixed pool of worker threads, one per hardware thread besides the main
+/// thread. Each worker owns a deque of jobs, pushing and popping its own work
+/// from the back while idle workers steal from the front of the others. The
+/// thread that starts the pool gets a deque too, so work submitted from the
+/// main thread is stolen rather than funneled through a shared queue.
+///
+/// The pool starts on first use, or explicitly through init().
+///
+/// Example:
+/// @code
+///   asw::jobs::Counter decoded;
+///   for (auto& file : files) {
+///       asw::jobs::run([&file] { file.decode(); }, &decoded);
+///   }
+///
+///   asw::jobs::Counter uploaded;
+///   asw::jobs::run_after(decoded, [&] { upload(files); }, &uploaded);
+///
+///   asw::jobs::parallel_for(0, particles.size(), 256, [&](size_t begin, size_t end) {
+///       for (size_t i = begin; i < end; ++i) {
+///           particles[i].update(dt);
+///       }
+///   });
+///
+///   asw::jobs::wait(uploaded);
+/// @endcode
+
+#ifndef ASW_JOBS_H
+#define ASW_JOBS_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+
+namespace asw::jobs {
+
+struct Job;
+struct Scheduler;
+
+/// @brief Range function for parallel_for, called as fn(begin, end).
+using RangeFn = std::function<void(size_t, size_t)>;
+
+/// @brief Counts jobs that have not finished yet.
+///
+/// Pass a counter when submitting jobs, then wait() on it or use it as a
+/// dependency of later jobs. A counter must outlive every job that signals it
+/// and every job that depends on it. Counters can be reused once they reach
+/// zero.
+///
+class Counter {
+public:
+    Counter() = default;
+    Counter(const Counter&) = delete;
+    Counter& operator=(const Counter&) = delete;
+    Counter(Counter&&) = delete;
+    Counter& operator=(Counter&&) = delete;
+    ~Counter() = default;
+
+    /// @brief Check if every job signalling this counter has finished.
+    ///
+    /// @return true once the count reaches zero.
+    ///
+    bool is_done() const;
+
+    /// @brief Get the number of jobs that have not finished yet.
+    ///
+    /// @return The pending count.
+    ///
+    int get_pending() const;
+
+private:
+    friend struct Scheduler;
+
+    void lock() const;
+    void unlock() const;
+
+    std::atomic<int> pending_ { 0 };
+
+    // Guards waiters_, and the final decrement so a finished counter can be
+    // destroyed as soon as is_done() returns true
+    mutable std::atomic<bool> locked_ { false };
+
+    // Jobs waiting for this counter to reach zero
+    Job* waiters_ { nullptr };
+};
+
+/// @brief Start the worker pool. Called automatically on first use, call it
+/// from the main thread to pick the worker count.
+///
+/// @param worker_count Number of worker threads. 0 uses one per hardware
+/// thread, minus one for the calling thread.
+///
+void init(size_t worker_count = 0);
+
+/// @brief Finish all queued jobs and stop the worker pool. Jobs still waiting
+/// on unfinished dependencies are dropped.
+///
+void shutdown();
+
+/// @brief Get the number of worker threads, not counting the main thread.
+///
+/// @return The worker count, 0 if the pool has not started.
+///
+size_t get_worker_count();
+
+/// @brief Check if the calling thread is a worker thread.
+///
+/// @return true on worker threads.
+///
+bool is_worker_thread();
+
+/// @brief Get the index of the calling thread in the pool, for per thread
+/// data such as staging buffers.
+///
+/// @return 0 for the thread that started the pool, 1 to get_worker_count()
+/// for workers, -1 for any other thread.
+///
+int get_thread_index();
+
+/// @brief Queue a job.
+///
+/// @param fn The job.
+/// @param counter Optional counter, incremented now and decremented when the
+/// job finishes.
+///
+void run(std::function<void()> fn, Counter* counter = nullptr);
+
+/// @brief Queue a job once every job signalling a counter has finished.
+///
+/// @param dependency The counter to wait for.
+/// @param fn The job.
+/// @param counter Optional counter, incremented now and decremented when the
+/// job finishes.
+///
+void run_after(Counter& dependency, std::function<void()> fn, Counter* counter = nullptr);
+
+/// @brief Call a function over an index range in parallel, blocking until
+/// every chunk is done. The range is split in halves until chunks are at most
+/// grain indices, so idle workers steal large chunks first.
+///
+/// @param begin First index.
+/// @param end One past the last index.
+/// @param grain Largest chunk passed to fn. 0 picks a size that gives each
+/// thread a few chunks.
+/// @param fn Called as fn(chunk_begin, chunk_end).
+///
+void parallel_for(size_t begin, size_t end, size_t grain, const RangeFn& fn);
+
+/// @brief Wait for a counter to reach zero. The calling thread runs queued
+/// jobs while it waits.
+///
+/// @param counter The counter to wait for.
+///
+void wait(const Counter& counter);
+
+} // namespace asw::jobs
+
+#endif // ASW_JOBS_H
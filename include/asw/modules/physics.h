@@ -0,0 +1,174 @@
+/// @file physics.h
+/// @author Allan Legemaate (alegemaate@gmail.com)
+/// @brief Broadphase collision queries for game objects
+/// @date 2026-10-18
+///
+/// @copyright Copyright (c) 2026
+///
+/// A uniform spatial hash over game object transforms. Every scene owns one
+/// and rebuilds it from its objects on the first query after an update, so
+/// scenes that never query pay nothing.
+///
+/// Example:
+/// @code
+///   bullet->collision_layer = LAYER_BULLET;
+///   bullet->collision_mask = LAYER_ENEMY;
+///
+///   auto& broadphase = get_broadphase();
+///   broadphase.for_each_pair([](auto& a, auto& b) { ... });
+///
+///   std::vector<asw::game::GameObject*> hits;
+///   broadphase.query_rect(explosion, hits, LAYER_ENEMY);
+/// @endcode
+
+#ifndef ASW_PHYSICS_H
+#define ASW_PHYSICS_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "./game.h"
+#include "./geometry.h"
+
+namespace asw::physics {
+
+/// @brief Mask matching every collision layer.
+constexpr uint32_t ALL_LAYERS = UINT32_MAX;
+
+/// @brief Default size of a spatial hash cell, in pixels.
+constexpr float DEFAULT_CELL_SIZE = 64.0F;
+
+/// @brief Result of a raycast.
+struct RayHit {
+    game::GameObject* object { nullptr };
+
+    // Distance along the ray to the hit
+    float distance { 0.0F };
+
+    // Point where the ray entered the object
+    Vec2<float> point;
+};
+
+/// @brief Uniform spatial hash over game objects.
+///
+/// Objects are only visible to queries if they are active and alive. Two
+/// objects form a pair when each one's layer is in the other's mask. Queries
+/// do not modify the hash, so several threads can query it at once.
+///
+class SpatialHash {
+public:
+    /// @brief Create a spatial hash.
+    ///
+    /// @param cell_size Size of a cell in pixels. Around the size of a typical
+    /// object works best.
+    ///
+    explicit SpatialHash(float cell_size = DEFAULT_CELL_SIZE);
+
+    /// @brief Set the cell size. Takes effect on the next rebuild.
+    ///
+    /// @param cell_size Size of a cell in pixels.
+    ///
+    void set_cell_size(float cell_size);
+
+    /// @brief Get the cell size.
+    ///
+    /// @return Size of a cell in pixels.
+    ///
+    float get_cell_size() const;
+
+    /// @brief Rebuild the hash from a set of objects.
+    ///
+    /// @param objects The objects to index.
+    ///
+    void rebuild(const std::vector<std::shared_ptr<game::GameObject>>& objects);
+
+    /// @brief Get the number of indexed objects.
+    ///
+    /// @return The object count.
+    ///
+    size_t size() const;
+
+    /// @brief Find objects overlapping a rectangle.
+    ///
+    /// @param rect The rectangle.
+    /// @param out Cleared, then filled with the objects found.
+    /// @param mask Only objects on these layers are returned.
+    ///
+    void query_rect(const Quad<float>& rect, std::vector<game::GameObject*>& out,
+        uint32_t mask = ALL_LAYERS) const;
+
+    /// @brief Find objects containing a point.
+    ///
+    /// @param point The point.
+    /// @param out Cleared, then filled with the objects found.
+    /// @param mask Only objects on these layers are returned.
+    ///
+    void query_point(const Vec2<float>& point, std::vector<game::GameObject*>& out,
+        uint32_t mask = ALL_LAYERS) const;
+
+    /// @brief Find the first object along a ray.
+    ///
+    /// @param origin Start of the ray.
+    /// @param direction Direction of the ray, does not need to be normalized.
+    /// @param max_distance How far to look.
+    /// @param mask Only objects on these layers are hit.
+    /// @return The nearest hit, if any.
+    ///
+    std::optional<RayHit> raycast(const Vec2<float>& origin, const Vec2<float>& direction,
+        float max_distance, uint32_t mask = ALL_LAYERS) const;
+
+    /// @brief Call a function for every overlapping pair of objects whose
+    /// layers and masks match. Each pair is reported once.
+    ///
+    /// @param fn Called as fn(GameObject& a, GameObject& b).
+    ///
+    void for_each_pair(
+        const std::function<void(game::GameObject&, game::GameObject&)>& fn) const;
+
+private:
+    struct CellRange {
+        int x0;
+        int y0;
+        int x1;
+        int y1;
+    };
+
+    struct Entry {
+        game::GameObject* object;
+        Quad<float> bounds;
+        uint32_t layer;
+        uint32_t mask;
+
+        // Cells the bounds cover
+        CellRange cells;
+    };
+
+    CellRange cells_of(const Quad<float>& rect) const;
+
+    uint32_t bucket_of(int x, int y) const;
+
+    /// @brief Call fn(entry_index) once for every entry in cells overlapping
+    /// the range, deduplicated across cells.
+    template <typename Fn> void visit(const CellRange& range, Fn&& fn) const;
+
+    float cell_size_;
+    float inv_cell_size_;
+
+    std::vector<Entry> entries_;
+
+    // Entries of each bucket, laid out contiguously by counting sort
+    std::vector<uint32_t> bucket_start_;
+    std::vector<uint32_t> bucket_entries_;
+    uint32_t bucket_mask_ { 0 };
+
+    // Reused scratch for rebuilds, (bucket, entry) per covered cell
+    std::vector<std::pair<uint32_t, uint32_t>> refs_;
+};
+
+} // namespace asw::physics
+
+#endif // ASW_PHYSICS_H
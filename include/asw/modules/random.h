@@ -5,12 +5,97 @@
 ///
 /// @copyright Copyright (c) 2025
 ///
+/// The free functions draw from a default stream seeded from the system at
+/// startup. Call seed() for reproducible runs. Streams use xoshiro256** and
+/// map to ranges without the standard distributions, so a seed gives the same
+/// sequence on every platform. Their state is 32 bytes, cheap enough to
+/// snapshot every tick.
 
 #ifndef ASW_RANDOM_H
 #define ASW_RANDOM_H
 
+#include <array>
+#include <cstdint>
+
 namespace asw::random {
 
+/// @brief Internal state of a stream.
+using State = std::array<uint64_t, 4>;
+
+/// @brief A seeded random number stream.
+///
+class Stream {
+public:
+    /// @brief Create a stream.
+    ///
+    /// @param seed The seed. Equal seeds give equal sequences.
+    ///
+    explicit Stream(uint64_t seed = 0);
+
+    /// @brief Restart the stream from a seed.
+    ///
+    /// @param seed The seed.
+    ///
+    void seed(uint64_t seed);
+
+    /// @brief Generate the next raw 64-bit value.
+    ///
+    /// @return uint64_t The random bits.
+    ///
+    uint64_t next();
+
+    /// @brief Generate a random integer between min and max, inclusive.
+    ///
+    /// @param min The minimum value.
+    /// @param max The maximum value.
+    /// @return int The random number.
+    ///
+    int between(int min, int max);
+
+    /// @brief Generate a random float in [min, max).
+    ///
+    /// @param min The minimum value.
+    /// @param max The maximum value.
+    /// @return float The random number.
+    ///
+    float between(float min, float max);
+
+    /// @brief Generate a random boolean with a given chance of being true.
+    ///
+    /// @param chance The chance of being true between 0 and 1.
+    /// @return true - Random true.
+    /// @return false - Random false.
+    ///
+    bool chance(float chance);
+
+    /// @brief Get the state, to restore later.
+    ///
+    /// @return State The state.
+    ///
+    State get_state() const;
+
+    /// @brief Restore a state from get_state().
+    ///
+    /// @param state The state.
+    ///
+    void set_state(const State& state);
+
+private:
+    State state_ {};
+};
+
+/// @brief Seed the default stream.
+///
+/// @param seed The seed.
+///
+void seed(uint64_t seed);
+
+/// @brief Get the default stream, to save or restore its state.
+///
+/// @return Stream& The default stream.
+///
+Stream& get_stream();
+
 /// @brief Generate a random integer between 0 and max.
 ///
 /// @param max The maximum value.
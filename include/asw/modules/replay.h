@@ -0,0 +1,145 @@
+/// @file replay.h
+/// @author Allan Legemaate (alegemaate@gmail.com)
+/// @brief Input recording and deterministic replay
+/// @date 2026-10-18
+///
+/// @copyright Copyright (c) 2026
+///
+/// Records every input hook call made by asw::core::update() into a compact
+/// binary stream, one block per tick. Replaying the stream feeds the same
+/// hook calls back in place of live input, so combined with the fixed
+/// timestep of asw::scene::SceneManager a session plays out identically
+/// every run.
+///
+/// Example:
+/// @code
+///   asw::input::start_recording();
+///   // ... play ...
+///   asw::input::save_recording("run.aswr", asw::input::stop_recording());
+///
+///   // Later, from the same starting point:
+///   asw::input::start_replay(asw::input::load_recording("run.aswr"));
+/// @endcode
+
+#ifndef ASW_REPLAY_H
+#define ASW_REPLAY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace asw::input {
+
+/// @brief A single input hook call, as dispatched by the core.
+///
+struct InputEvent {
+    /// @brief Which hook the event is for.
+    enum class Type : uint8_t {
+        KeyDown,
+        KeyUp,
+        MouseButtonDown,
+        MouseButtonUp,
+        MouseMotion,
+        MouseWheel,
+        ControllerAdded,
+        ControllerRemoved,
+        ControllerAxisMotion,
+        ControllerButtonDown,
+        ControllerButtonUp,
+        Text,
+    };
+
+    Type type { Type::KeyDown };
+
+    // Scancode, mouse button or controller id
+    uint32_t code { 0 };
+
+    // Controller axis or button
+    uint32_t index { 0 };
+
+    // Motion position, wheel delta or axis value
+    float x { 0.0F };
+    float y { 0.0F };
+
+    // Relative motion
+    float delta_x { 0.0F };
+    float delta_y { 0.0F };
+
+    // When the event happened, in SDL_GetTicksNS() time
+    uint64_t timestamp { 0 };
+
+    // Text input
+    std::string text {};
+};
+
+/// @brief Start recording input. Any previous recording is discarded.
+///
+void start_recording();
+
+/// @brief Stop recording input.
+///
+/// @return The recorded stream.
+///
+std::vector<uint8_t> stop_recording();
+
+/// @brief Check if input is being recorded.
+///
+/// @return True while recording.
+///
+bool is_recording();
+
+/// @brief Replay a recorded stream in place of live input.
+///
+/// @details Live input events are ignored until the stream runs out or
+/// stop_replay() is called. Window and quit events are still handled.
+///
+/// @param data The recorded stream.
+/// @return True if the stream header is valid and replay started.
+///
+bool start_replay(std::vector<uint8_t> data);
+
+/// @brief Stop replaying and return to live input.
+///
+void stop_replay();
+
+/// @brief Check if a recording is being replayed.
+///
+/// @return True while replaying.
+///
+bool is_replaying();
+
+/// @brief Write a recorded stream to a file.
+///
+/// @param path Path of the file to write.
+/// @param data The recorded stream.
+/// @return True if the file was written.
+///
+bool save_recording(const std::string& path, const std::vector<uint8_t>& data);
+
+/// @brief Read a recorded stream from a file.
+///
+/// @param path Path of the file to read.
+/// @return The recorded stream, empty on failure.
+///
+std::vector<uint8_t> load_recording(const std::string& path);
+
+/// @brief Start an input tick. Called by the core before polling events.
+///
+/// @details While replaying, this feeds the recorded events of the tick.
+///
+void _begin_tick();
+
+/// @brief End an input tick. Called by the core after polling events.
+///
+void _end_tick();
+
+/// @brief Dispatch a live input event to its hook, recording it if needed.
+/// Called by the core.
+///
+/// @param event The event to dispatch.
+///
+void _dispatch(const InputEvent& event);
+
+} // namespace asw::input
+
+#endif // ASW_REPLAY_H
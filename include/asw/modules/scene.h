@@ -9,17 +9,38 @@
 #ifndef ASW_SCENE_H
 #define ASW_SCENE_H
 
+#include <SDL3/SDL.h>
 #include <algorithm>
+#include <array>
 #include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <new>
+#include <numbers>
+#include <optional>
 #include <ranges>
+#include <span>
+#include <typeindex>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "./assets.h"
 #include "./core.h"
 #include "./display.h"
+#include "./ecs.h"
 #include "./game.h"
+#include "./jobs.h"
+#include "./log.h"
+#include "./physics.h"
+#include "./random.h"
+#include "./serialize.h"
+#include "./util.h"
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
@@ -30,6 +51,273 @@ namespace asw::scene {
 /// @brief Default time step for the game loop.
 constexpr auto DEFAULT_TIMESTEP = std::chrono::milliseconds(8);
 
+/// @brief Magic bytes at the start of a scene snapshot.
+constexpr std::array<uint8_t, 4> SNAPSHOT_MAGIC { 'A', 'S', 'W', 'S' };
+
+/// @brief Version of the scene snapshot format. Version 2 added objects
+/// waiting to be created and the scene's own state.
+constexpr uint8_t SNAPSHOT_VERSION = 2;
+
+/// @brief Default cap on fixed updates run before each draw.
+constexpr int DEFAULT_MAX_UPDATES_PER_FRAME = 8;
+
+/// @brief Frame time statistics of the managed loop, over the last second.
+struct FrameStats {
+    /// @brief Summary of a set of durations, in milliseconds.
+    struct Times {
+        float min_ms { 0.0F };
+        float avg_ms { 0.0F };
+        float p99_ms { 0.0F };
+        float max_ms { 0.0F };
+    };
+
+    // Time from the start of one frame to the next, including pacing sleeps
+    Times interval;
+
+    // Time spent updating and drawing each frame, what a frame really costs
+    Times work;
+
+    // Fixed updates skipped to catch up after stalls, since start
+    uint64_t dropped_updates { 0 };
+};
+
+/// @brief Default number of past ticks a deterministic scene manager can roll
+/// back to.
+constexpr size_t DEFAULT_ROLLBACK_TICKS = 64;
+
+/// @brief Rollback counters of a deterministic scene manager.
+struct RollbackStats {
+    // Rollbacks performed and ticks resimulated by them
+    uint64_t rollbacks { 0 };
+    uint64_t resimulated_ticks { 0 };
+
+    // Time spent resimulating, in milliseconds
+    float total_ms { 0.0F };
+
+    // Length of the last rollback
+    uint64_t last_ticks { 0 };
+    float last_ms { 0.0F };
+
+    // Rollbacks that took longer than the budget
+    uint64_t over_budget { 0 };
+};
+
+/// @brief Default number of thread safe objects each update job handles.
+constexpr size_t DEFAULT_PARALLEL_GRAIN = 64;
+
+/// @brief Default number of freed object blocks kept for reuse, per object
+/// type. Pooling is opt in.
+constexpr size_t DEFAULT_OBJECT_POOL_LIMIT = 0;
+
+/// @brief Object lifetime counters of a scene.
+struct ObjectStats {
+    // Objects created, including recycled ones
+    uint64_t spawned { 0 };
+
+    // Dead objects removed from the scene
+    uint64_t destroyed { 0 };
+
+    // Spawns served from a pool instead of a new allocation
+    uint64_t recycled { 0 };
+
+    // Freed object blocks currently waiting in pools
+    uint64_t pooled { 0 };
+};
+
+/// @brief Freed memory of one object type, for create_object() to reuse.
+///
+/// Objects are destroyed as usual when their last owner lets go. Their block
+/// comes back to the pool only once the last weak_ptr is gone too, so a
+/// weak_ptr never sees a reused object. Blocks can come back on any thread.
+///
+class ObjectPool {
+public:
+    explicit ObjectPool(size_t limit)
+        : limit_(limit)
+    {
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    ~ObjectPool()
+    {
+        for (void* block : blocks_) {
+            ::operator delete(block, std::align_val_t(align_));
+        }
+    }
+
+    /// @brief Take a block from the pool, or allocate a new one.
+    ///
+    /// @param size Size of the block.
+    /// @param align Alignment of the block.
+    /// @return The block.
+    ///
+    void* allocate(size_t size, size_t align)
+    {
+        {
+            const std::scoped_lock lock(mutex_);
+
+            if (size_ == 0) {
+                size_ = size;
+                align_ = align;
+            }
+
+            if (size == size_ && align == align_ && !blocks_.empty()) {
+                void* block = blocks_.back();
+                blocks_.pop_back();
+                reused_++;
+                return block;
+            }
+        }
+
+        return ::operator new(size, std::align_val_t(align));
+    }
+
+    /// @brief Give a block back, freeing it if the pool is full.
+    ///
+    /// @param block The block.
+    /// @param size Size of the block.
+    /// @param align Alignment of the block.
+    ///
+    void deallocate(void* block, size_t size, size_t align)
+    {
+        {
+            const std::scoped_lock lock(mutex_);
+
+            if (size == size_ && align == align_ && blocks_.size() < limit_) {
+                blocks_.push_back(block);
+                return;
+            }
+        }
+
+        ::operator delete(block, std::align_val_t(align));
+    }
+
+    /// @brief Set how many free blocks are kept, freeing any over it.
+    ///
+    /// @param limit The limit.
+    ///
+    void set_limit(size_t limit)
+    {
+        const std::scoped_lock lock(mutex_);
+        limit_ = limit;
+
+        while (blocks_.size() > limit_) {
+            ::operator delete(blocks_.back(), std::align_val_t(align_));
+            blocks_.pop_back();
+        }
+    }
+
+    /// @brief Get the number of free blocks.
+    ///
+    /// @return The number of free blocks.
+    ///
+    size_t size() const
+    {
+        const std::scoped_lock lock(mutex_);
+        return blocks_.size();
+    }
+
+    /// @brief Take the number of allocations served from the pool since the
+    /// last call.
+    ///
+    /// @return The number of reused blocks.
+    ///
+    uint64_t take_reused()
+    {
+        const std::scoped_lock lock(mutex_);
+        return std::exchange(reused_, 0);
+    }
+
+    // Make a default constructed object of the pool's type in pooled memory,
+    // nullptr if the type is not default constructible
+    std::shared_ptr<game::GameObject> (*create)(const std::shared_ptr<ObjectPool>&) { nullptr };
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<void*> blocks_;
+    size_t size_ { 0 };
+    size_t align_ { 0 };
+    size_t limit_;
+    uint64_t reused_ { 0 };
+};
+
+/// @brief Allocator that draws from an object pool, for std::allocate_shared.
+///
+/// @tparam U The allocated type.
+///
+template <typename U> class PoolAllocator {
+public:
+    using value_type = U;
+
+    explicit PoolAllocator(std::shared_ptr<ObjectPool> pool)
+        : pool(std::move(pool))
+    {
+    }
+
+    template <typename V>
+    explicit(false) PoolAllocator(const PoolAllocator<V>& other)
+        : pool(other.pool)
+    {
+    }
+
+    U* allocate(size_t count)
+    {
+        return static_cast<U*>(pool->allocate(count * sizeof(U), alignof(U)));
+    }
+
+    void deallocate(U* block, size_t count)
+    {
+        pool->deallocate(block, count * sizeof(U), alignof(U));
+    }
+
+    template <typename V> bool operator==(const PoolAllocator<V>& other) const
+    {
+        return pool == other.pool;
+    }
+
+    // Shared, so blocks freed after the scene is gone still have a home
+    std::shared_ptr<ObjectPool> pool;
+};
+
+/// @brief Type erased registry of the scene's objects of one type.
+class ObjectBucketBase {
+public:
+    virtual ~ObjectBucketBase() = default;
+
+    /// @brief Add the object if it is of the bucket's type.
+    ///
+    /// @param obj The object.
+    ///
+    virtual void try_add(game::GameObject* obj) = 0;
+
+    /// @brief Drop dead objects.
+    ///
+    virtual void prune() = 0;
+};
+
+/// @brief Registry of the scene's objects that are, or derive from, a type.
+///
+/// @tparam ObjectType The object type.
+///
+template <typename ObjectType> class ObjectBucket : public ObjectBucketBase {
+public:
+    void try_add(game::GameObject* obj) override
+    {
+        if (auto* casted = dynamic_cast<ObjectType*>(obj); casted != nullptr) {
+            items.push_back(casted);
+        }
+    }
+
+    void prune() override
+    {
+        std::erase_if(items, [](const ObjectType* obj) { return !obj->alive; });
+    }
+
+    std::vector<ObjectType*> items;
+};
+
 /// @brief Forward declaration of the SceneManager class.
 template <typename T> class SceneManager;
 
@@ -71,12 +359,45 @@ public:
         // Erase inactive objects. Scanning first keeps the compaction pass off
         // frames where nothing actually died.
         if (std::ranges::any_of(_objects, [](const auto& obj) { return !obj->alive; })) {
-            std::erase_if(_objects, [](const auto& obj) { return !obj->alive; });
+            // Buckets hold raw pointers, drop them while the scene still owns
+            // the objects
+            for (auto& [type, bucket] : _buckets) {
+                bucket->prune();
+            }
+
+            std::erase_if(_objects, [this](const auto& obj) {
+                if (obj->alive) {
+                    return false;
+                }
+
+                remove_from_layer(obj.get());
+                _stats.destroyed++;
+                return true;
+            });
         }
 
-        // Update all objects in the scene
+        // Keep the state going into this tick, draws blend from it
         for (auto const& obj : _objects) {
-            if (obj->active && obj->alive) {
+            obj->reset_interpolation();
+        }
+
+        // Update thread safe objects across the job system, then the rest in
+        // order on this thread
+        _parallel_objects.clear();
+        if (_parallel_enabled) {
+            for (auto const& obj : _objects) {
+                if (obj->thread_safe && obj->active && obj->alive) {
+                    _parallel_objects.push_back(obj.get());
+                }
+            }
+        }
+
+        if (!_parallel_objects.empty()) {
+            update_parallel(dt);
+        }
+
+        for (auto const& obj : _objects) {
+            if ((!obj->thread_safe || !_parallel_enabled) && obj->active && obj->alive) {
                 obj->update(dt);
             }
         }
@@ -85,10 +406,25 @@ public:
         if (!_obj_to_create.empty()) {
             _objects.reserve(_objects.size() + _obj_to_create.size());
             _objects.insert(_objects.end(), _obj_to_create.begin(), _obj_to_create.end());
+
+            for (const auto& obj : _obj_to_create) {
+                obj->reset_interpolation();
+                add_to_buckets(obj.get());
+                add_to_layer(obj.get());
+            }
         }
 
         // Clear the objects to create
         _obj_to_create.clear();
+
+        // Run entity systems. The world is not in snapshots, so it only steps
+        // on a tick's first run
+        if (!_resimulating) {
+            _world.update(dt);
+        }
+
+        // Objects moved, rebuild the broadphase on the next query
+        _broadphase_stale = true;
     };
 
     /// @brief Draw the game scene.
@@ -97,17 +433,56 @@ public:
     ///
     virtual void draw()
     {
-        // Sort objects by z-index. The check is a linear read, so already
-        // ordered scenes skip the sort entirely.
-        if (!std::ranges::is_sorted(_objects, std::less {}, &game::GameObject::z_index)) {
-            std::ranges::sort(_objects, std::less {}, &game::GameObject::z_index);
+        // Refile objects whose z index changed at the back of their new layer
+        for (auto const& obj : _objects) {
+            if (obj->z_index != obj->_draw_slot.layer) {
+                remove_from_layer(obj.get());
+                add_to_layer(obj.get());
+            }
         }
 
-        for (auto const& obj : _objects) {
-            if (obj->active) {
-                obj->draw();
+        for (auto it = _layers.begin(); it != _layers.end();) {
+            auto& layer = it->second;
+
+            if (layer.holes * 2 > layer.items.size()
+                || (_batch_by_texture && layer.holes > 0)) {
+                compact_layer(layer);
+            }
+
+            if (layer.items.empty()) {
+                it = _layers.erase(it);
+                continue;
+            }
+
+            if (_batch_by_texture) {
+                batch_layer(layer);
+            }
+
+            for (auto* obj : layer.items) {
+                if (obj != nullptr && obj->active) {
+                    draw_object(*obj);
+                }
             }
+
+            ++it;
         }
+
+        _world.draw();
+    };
+
+    /// @brief Called when another scene is pushed on top of this one.
+    ///
+    /// @details The scene keeps its state but is not updated until the scene
+    /// above it is popped.
+    ///
+    virtual void on_pause() {
+        // Default implementation does nothing
+    };
+
+    /// @brief Called when the scene above this one is popped.
+    ///
+    virtual void on_resume() {
+        // Default implementation does nothing
     };
 
     /// @brief Handle input for the game scene.
@@ -118,6 +493,15 @@ public:
     virtual void cleanup()
     {
         _objects.clear();
+        _obj_to_create.clear();
+        _parallel_objects.clear();
+        _staged.clear();
+        _layers.clear();
+        _pools.clear();
+        _buckets.clear();
+        _broadphase_stale = true;
+        _world.clear();
+        _world.clear_systems();
     };
 
     /// @brief Add a game object to the scene.
@@ -126,11 +510,23 @@ public:
     ///
     void register_object(const std::shared_ptr<game::GameObject>& obj)
     {
+        obj->reset_interpolation();
         _objects.push_back(obj);
+        add_to_buckets(obj.get());
+        add_to_layer(obj.get());
+        _broadphase_stale = true;
     }
 
     /// @brief Create a new game object in the scene.
     ///
+    /// With an object pool limit set, the memory of freed objects of the same
+    /// type is reused instead of being allocated again. Objects created here
+    /// and restored by load_snapshot() share the pool of their type.
+    ///
+    /// Safe to call from the update of a thread safe object. Objects created
+    /// there are staged per thread, skip the pools, and join the scene with
+    /// the rest of the frame's new objects.
+    ///
     /// @param gameObject The game object to add to the scene.
     ///
     template <typename ObjectType, typename... Args>
@@ -141,11 +537,100 @@ public:
         static_assert(std::is_constructible_v<ObjectType, Args...>,
             "ObjectType must be constructible with the given arguments");
 
-        auto obj = std::make_shared<ObjectType>(std::forward<Args>(args)...);
+        if (_parallel_update) {
+            auto obj = std::make_shared<ObjectType>(std::forward<Args>(args)...);
+            _staged[jobs::get_thread_index() + 1].objects.emplace_back(obj);
+            return obj;
+        }
+
+        std::shared_ptr<ObjectType> obj;
+
+        if (_pool_limit == 0) {
+            obj = std::make_shared<ObjectType>(std::forward<Args>(args)...);
+        } else {
+            obj = std::allocate_shared<ObjectType>(
+                PoolAllocator<ObjectType>(get_pool<ObjectType>()), std::forward<Args>(args)...);
+        }
+
+        _stats.spawned++;
         _obj_to_create.emplace_back(obj);
         return obj;
     }
 
+    /// @brief Group objects that share a texture within each layer, so the
+    /// renderer can batch their draws. Objects keep their relative order within
+    /// a texture, but no longer across textures.
+    ///
+    /// @param enabled Whether to batch by texture.
+    ///
+    void set_texture_batching(bool enabled)
+    {
+        _batch_by_texture = enabled;
+    }
+
+    /// @brief Set how many thread safe objects each update job handles.
+    ///
+    /// @param grain Objects per job. Scenes with no more thread safe objects
+    /// than this update them on the calling thread.
+    ///
+    void set_parallel_grain(size_t grain)
+    {
+        _parallel_grain = std::max<size_t>(grain, 1);
+    }
+
+    /// @brief Allow thread safe objects to update in parallel. Objects created
+    /// during a parallel update are added in an order that depends on thread
+    /// timing, so deterministic simulations turn this off.
+    ///
+    /// @param enabled Whether to update thread safe objects in parallel.
+    ///
+    void set_parallel_update(bool enabled)
+    {
+        _parallel_enabled = enabled;
+    }
+
+    /// @brief Set how many freed objects of each type have their memory kept
+    /// for reuse by create_object(). Off by default.
+    ///
+    /// @param limit The limit per type. 0 disables pooling.
+    ///
+    void set_object_pool_limit(size_t limit)
+    {
+        _pool_limit = limit;
+
+        for (auto& [type, pool] : _pools) {
+            pool->set_limit(limit);
+        }
+    }
+
+    /// @brief Get the object lifetime counters.
+    ///
+    /// @return The counters.
+    ///
+    ObjectStats get_object_stats()
+    {
+        _stats.pooled = 0;
+        for (auto& [type, pool] : _pools) {
+            _stats.recycled += pool->take_reused();
+            _stats.pooled += pool->size();
+        }
+
+        return _stats;
+    }
+
+    /// @brief Reset the spawned, destroyed and recycled counters.
+    ///
+    void reset_object_stats()
+    {
+        for (auto& [type, pool] : _pools) {
+            pool->take_reused();
+        }
+
+        _stats.spawned = 0;
+        _stats.destroyed = 0;
+        _stats.recycled = 0;
+    }
+
     /// @brief Get game objects in the scene.
     ///
     /// @return A vector of shared pointers to game objects in the scene.
@@ -155,24 +640,363 @@ public:
         return _objects;
     }
 
-    /// @brief Get game objects of a specific type in the scene.
+    /// @brief Get game objects of a specific type in the scene, including
+    /// objects of derived types.
+    ///
+    /// The scene keeps a registry per queried type, filled on the first query
+    /// and kept up to date as objects are created and erased, so later queries
+    /// cost nothing. The span is valid until the next update. Thread safe
+    /// objects may only query types that were queried before, such as in
+    /// init(), since their updates cannot fill a new registry.
     ///
     /// @tparam ObjectType The type of the game object to get.
-    /// @return A vector of shared pointers to game objects of the specified
+    /// @return A span of non-owning pointers to game objects of the specified
     /// type in the scene.
     ///
-    template <typename ObjectType> std::vector<std::shared_ptr<ObjectType>> get_object_view()
+    template <typename ObjectType> std::span<ObjectType* const> get_object_view()
     {
         static_assert(std::is_base_of_v<game::GameObject, ObjectType>,
             "ObjectType must be derived from Scene<T>");
 
-        std::vector<std::shared_ptr<ObjectType>> result;
+        // Registries are read only while thread safe objects update
+        if (_parallel_update) {
+            auto it = _buckets.find(typeid(ObjectType));
+            if (it == _buckets.end()) {
+                asw::util::abort_on_error(
+                    "get_object_view() of a type not queried before, from a thread safe update");
+            }
+
+            return static_cast<ObjectBucket<ObjectType>&>(*it->second).items;
+        }
+
+        auto& bucket = _buckets[typeid(ObjectType)];
+        if (bucket == nullptr) {
+            bucket = std::make_unique<ObjectBucket<ObjectType>>();
+            for (const auto& obj : _objects) {
+                bucket->try_add(obj.get());
+            }
+        }
+
+        return static_cast<ObjectBucket<ObjectType>&>(*bucket).items;
+    }
+
+    /// @brief Get the collision broadphase of the scene's objects. It is
+    /// rebuilt from the objects' transforms on the first call after an update.
+    ///
+    /// Once used, it is also rebuilt before thread safe objects update, and
+    /// is read only while they do. Their updates must not be the first to use
+    /// it, or invalidate it.
+    ///
+    /// @return Reference to the broadphase.
+    ///
+    physics::SpatialHash& get_broadphase()
+    {
+        // Read only while thread safe objects update
+        if (_parallel_update) {
+            if (_broadphase_stale) {
+                asw::util::abort_on_error(
+                    "get_broadphase() first used, or invalidated, from a thread safe update");
+            }
+
+            return _broadphase;
+        }
+
+        _broadphase_used = true;
+
+        if (_broadphase_stale) {
+            _broadphase.rebuild(_objects);
+            _broadphase_stale = false;
+        }
+
+        return _broadphase;
+    }
+
+    /// @brief Force the broadphase to rebuild on its next use, for objects
+    /// moved outside of update.
+    ///
+    void invalidate_broadphase()
+    {
+        _broadphase_stale = true;
+    }
+
+    /// @brief Write state of the scene itself to snapshots, such as a round
+    /// timer or score. Objects are saved separately.
+    ///
+    /// @param writer The snapshot being written.
+    ///
+    virtual void serialize_state(serialize::BinaryWriter& /*writer*/) const
+    {
+        // Default implementation does nothing
+    }
+
+    /// @brief Read back the state written by serialize_state().
+    ///
+    /// @param reader The scene's state from a snapshot.
+    ///
+    virtual void deserialize_state(serialize::BinaryReader& /*reader*/)
+    {
+        // Default implementation does nothing
+    }
+
+    /// @brief Write every live object of the scene to a buffer.
+    ///
+    /// Objects are written with their registered type and
+    /// GameObject::serialize(), followed by serialize_state(). Objects of
+    /// types not registered with serialize::register_type() are left out, and
+    /// load_snapshot() leaves them in place.
+    ///
+    /// @return The snapshot.
+    ///
+    std::vector<uint8_t> save_snapshot() const
+    {
+        serialize::BinaryWriter writer;
+        save_snapshot(writer);
+        return writer.take();
+    }
+
+    /// @brief Append a snapshot of the scene to a writer. Reusing a writer
+    /// avoids allocating for every snapshot.
+    ///
+    /// @param writer The writer.
+    ///
+    void save_snapshot(serialize::BinaryWriter& writer) const
+    {
+        // Core fields plus type and length, most objects fit
+        constexpr size_t TYPICAL_RECORD_SIZE = 80;
+
+        writer.reserve(writer.size() + SNAPSHOT_MAGIC.size() + 13
+            + ((_objects.size() + _obj_to_create.size()) * TYPICAL_RECORD_SIZE));
+
+        writer.write_bytes(SNAPSHOT_MAGIC);
+        writer.write_u8(SNAPSHOT_VERSION);
+
+        const size_t count_offset = writer.size();
+        writer.write_u32(0);
+        writer.write_u32(0);
+
+        uint32_t count = 0;
+        _snapshot_types.clear();
+
+        auto write_object = [&](const game::GameObject& obj) {
+            if (!obj.alive) {
+                return;
+            }
+
+            // Unregistered objects are not part of the snapshot, loading
+            // leaves them in place
+            const auto* type_info = find_snapshot_type(obj);
+            if (type_info == nullptr) {
+                return;
+            }
+
+            writer.write_u64(type_info->hash);
+            const size_t length_offset = writer.size();
+            writer.write_u32(0);
+            obj.serialize(writer);
+            writer.patch_u32(length_offset,
+                static_cast<uint32_t>(writer.size() - length_offset - sizeof(uint32_t)));
+            count++;
+        };
+
         for (const auto& obj : _objects) {
-            if (auto casted_obj = std::dynamic_pointer_cast<ObjectType>(obj)) {
-                result.push_back(casted_obj);
+            write_object(*obj);
+        }
+
+        // Objects waiting to be added come last, and are restored as waiting
+        const uint32_t added = count;
+        for (const auto& obj : _obj_to_create) {
+            write_object(*obj);
+        }
+
+        writer.patch_u32(count_offset, count);
+        writer.patch_u32(count_offset + sizeof(uint32_t), count - added);
+
+        const size_t state_offset = writer.size();
+        writer.write_u32(0);
+        serialize_state(writer);
+        writer.patch_u32(
+            state_offset, static_cast<uint32_t>(writer.size() - state_offset - sizeof(uint32_t)));
+    }
+
+    /// @brief Replace the scene's objects with the ones in a snapshot.
+    ///
+    /// The snapshot is validated before the scene is touched. Current objects
+    /// are freed, and with an object pool limit set, restored objects reuse
+    /// their memory, so restarting a level allocates little. Objects of
+    /// unregistered types and entities of the world are left alone, restored
+    /// objects update and draw after them. Do not call from a game object's
+    /// update.
+    ///
+    /// @param data A snapshot from save_snapshot().
+    /// @return true on success. On false the scene is unchanged, unless an
+    /// object failed to read its own fields, which is logged.
+    ///
+    bool load_snapshot(std::span<const uint8_t> data)
+    {
+        serialize::BinaryReader reader(data);
+
+        const auto magic = reader.read_bytes(SNAPSHOT_MAGIC.size());
+        const uint8_t version = reader.read_u8();
+        if (!reader.ok() || !std::ranges::equal(magic, SNAPSHOT_MAGIC)) {
+            asw::log::error("Not a scene snapshot");
+            return false;
+        }
+
+        if (version == 0 || version > SNAPSHOT_VERSION) {
+            asw::log::error("Unsupported scene snapshot version {}", version);
+            return false;
+        }
+
+        const uint32_t count = reader.read_u32();
+        const uint32_t pending = version >= 2 ? reader.read_u32() : 0;
+        const size_t records_start = reader.position();
+
+        if (pending > count) {
+            reader.fail();
+        }
+
+        auto& seen = _snapshot_seen;
+        seen.clear();
+
+        auto find_seen = [&seen](uint64_t hash) {
+            return std::ranges::find(seen, hash, &SeenType::hash);
+        };
+
+        // Check the framing and types of every record first
+        for (uint32_t i = 0; i < count && reader.ok(); ++i) {
+            const uint64_t hash = reader.read_u64();
+            reader.skip(reader.read_u32());
+
+            if (!reader.ok() || find_seen(hash) != seen.end()) {
+                continue;
             }
+
+            const auto* info = serialize::find_type(hash);
+            if (info == nullptr) {
+                asw::log::error("Scene snapshot has an unregistered type {:016x}", hash);
+                return false;
+            }
+
+            seen.push_back({ hash, info, nullptr });
+        }
+
+        std::span<const uint8_t> state;
+        if (version >= 2) {
+            state = reader.read_bytes(reader.read_u32());
+        }
+
+        if (!reader.ok()) {
+            asw::log::error("Scene snapshot is truncated");
+            return false;
         }
-        return result;
+
+        clear_snapshot_objects();
+        _objects.reserve(_objects.size() + count);
+
+        // Types created here before reuse the memory of the objects just freed
+        if (_pool_limit > 0) {
+            for (auto& type : seen) {
+                if (auto it = _pools.find(type.info->type);
+                    it != _pools.end() && it->second->create != nullptr) {
+                    type.pool = it->second;
+                }
+            }
+        }
+
+        serialize::BinaryReader records(data.subspan(records_start));
+        bool ok = true;
+
+        for (uint32_t i = 0; i < count; ++i) {
+            const auto& seen_type = *find_seen(records.read_u64());
+            const auto* type = seen_type.info;
+            const auto payload = records.read_bytes(records.read_u32());
+
+            const auto& pool = seen_type.pool;
+            auto obj = pool != nullptr ? pool->create(pool) : type->create();
+
+            serialize::BinaryReader object_reader(payload);
+            obj->deserialize(object_reader);
+
+            if (!object_reader.ok() || object_reader.remaining() != 0) {
+                asw::log::error("Scene snapshot record for \"{}\" does not match its reader",
+                    type->name);
+                ok = false;
+            }
+
+            if (i >= count - pending) {
+                _obj_to_create.push_back(obj);
+                continue;
+            }
+
+            obj->reset_interpolation();
+            _objects.push_back(obj);
+            add_to_layer(obj.get());
+        }
+
+        if (version >= 2) {
+            serialize::BinaryReader state_reader(state);
+            deserialize_state(state_reader);
+
+            if (!state_reader.ok() || state_reader.remaining() != 0) {
+                asw::log::error("Scene snapshot state does not match the scene's reader");
+                ok = false;
+            }
+        }
+
+        _broadphase_stale = true;
+        return ok;
+    }
+
+    /// @brief Set how far the next draw is between the last two updates. Set
+    /// by the scene manager before each draw.
+    ///
+    /// @param alpha 0 draws the state before the last update, 1 the current
+    /// state.
+    ///
+    void set_interpolation_alpha(float alpha)
+    {
+        _interpolation_alpha = std::clamp(alpha, 0.0F, 1.0F);
+    }
+
+    /// @brief Get how far the current draw is between the last two updates,
+    /// for blending custom state in draw().
+    ///
+    /// @return The blend factor from 0 to 1.
+    ///
+    float get_interpolation_alpha() const
+    {
+        return _interpolation_alpha;
+    }
+
+    /// @brief Mark updates as resimulating ticks after a rollback. Set by the
+    /// scene manager.
+    ///
+    /// @param resimulating Whether updates are resimulated ticks.
+    ///
+    void set_resimulating(bool resimulating)
+    {
+        _resimulating = resimulating;
+    }
+
+    /// @brief Check if the current update resimulates a tick after a rollback,
+    /// to skip effects such as sounds that already played on its first run.
+    ///
+    /// @return true while resimulating.
+    ///
+    bool is_resimulating() const
+    {
+        return _resimulating;
+    }
+
+    /// @brief Get the entity world of the scene. It is updated and drawn after
+    /// the scene's game objects. The world is not part of snapshots, so
+    /// resimulated ticks do not update it.
+    ///
+    /// @return Reference to the world.
+    ///
+    ecs::World& get_world()
+    {
+        return _world;
     }
 
 protected:
@@ -180,6 +1004,307 @@ protected:
     SceneManager<T>& manager;
 
 private:
+    /// @brief Get the pool of a type, creating it on first use.
+    ///
+    /// @tparam ObjectType The exact object type.
+    /// @return The pool.
+    ///
+    template <typename ObjectType> const std::shared_ptr<ObjectPool>& get_pool()
+    {
+        auto& pool = _pools[typeid(ObjectType)];
+        if (pool == nullptr) {
+            pool = std::make_shared<ObjectPool>(_pool_limit);
+
+            if constexpr (std::is_default_constructible_v<ObjectType>) {
+                pool->create = [](const std::shared_ptr<ObjectPool>& owner) {
+                    return std::static_pointer_cast<game::GameObject>(
+                        std::allocate_shared<ObjectType>(PoolAllocator<ObjectType>(owner)));
+                };
+            }
+        }
+
+        return pool;
+    }
+
+    /// @brief Update the collected thread safe objects in parallel, then merge
+    /// the objects they created.
+    ///
+    /// @param dt The time in seconds since the last update.
+    ///
+    void update_parallel(float dt)
+    {
+        if (_parallel_objects.size() <= _parallel_grain) {
+            for (auto* obj : _parallel_objects) {
+                obj->update(dt);
+            }
+            return;
+        }
+
+        if (jobs::get_worker_count() == 0) {
+            jobs::init();
+        }
+
+        // One staging list per pool thread, plus one for a caller outside it
+        _staged.resize(jobs::get_worker_count() + 2);
+
+        // Workers may query the broadphase, build it while only this thread
+        // runs
+        if (_broadphase_used) {
+            get_broadphase();
+        }
+
+        _parallel_update = true;
+        jobs::parallel_for(0, _parallel_objects.size(), _parallel_grain,
+            [this, dt](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    _parallel_objects[i]->update(dt);
+                }
+            });
+        _parallel_update = false;
+
+        for (auto& staged : _staged) {
+            _stats.spawned += staged.objects.size();
+            _obj_to_create.insert(_obj_to_create.end(),
+                std::make_move_iterator(staged.objects.begin()),
+                std::make_move_iterator(staged.objects.end()));
+            staged.objects.clear();
+        }
+    }
+
+    /// @brief Objects drawn at one z index.
+    struct DrawLayer {
+        // In the order they joined the layer, nullptr where one left
+        std::vector<game::GameObject*> items;
+
+        // Number of nullptr entries in items
+        size_t holes { 0 };
+    };
+
+    /// @brief Draw an object, blended between its last two updates.
+    ///
+    /// @param obj The object.
+    ///
+    void draw_object(game::GameObject& obj)
+    {
+        const float alpha = _interpolation_alpha;
+
+        if (alpha >= 1.0F || !obj.interpolate) {
+            obj.draw();
+            return;
+        }
+
+        // Draw at the blended state, then put the simulated one back
+        const auto transform = obj.transform;
+        const float rotation = obj.rotation;
+        obj.transform = obj.prev_transform + ((transform - obj.prev_transform) * alpha);
+        // Turn the short way round when the rotation wrapped between updates
+        const float turn
+            = std::remainder(rotation - obj.prev_rotation, 2.0F * std::numbers::pi_v<float>);
+        obj.rotation = obj.prev_rotation + (turn * alpha);
+        obj.draw();
+        obj.transform = transform;
+        obj.rotation = rotation;
+    }
+
+    /// @brief File an object at the back of the layer of its z index.
+    ///
+    /// @param obj The object.
+    ///
+    void add_to_layer(game::GameObject* obj)
+    {
+        auto& layer = _layers[obj->z_index];
+        obj->_draw_slot.layer = obj->z_index;
+        obj->_draw_slot.index = static_cast<uint32_t>(layer.items.size());
+        layer.items.push_back(obj);
+    }
+
+    /// @brief Take an object out of its layer, leaving a hole so the rest keep
+    /// their positions.
+    ///
+    /// @param obj The object.
+    ///
+    void remove_from_layer(game::GameObject* obj)
+    {
+        auto& slot = obj->_draw_slot;
+
+        if (auto it = _layers.find(slot.layer); it != _layers.end()) {
+            auto& items = it->second.items;
+            if (slot.index < items.size() && items[slot.index] == obj) {
+                items[slot.index] = nullptr;
+                it->second.holes++;
+            }
+        }
+
+        slot.index = UINT32_MAX;
+    }
+
+    /// @brief Close the holes of a layer, keeping the order of the rest.
+    ///
+    /// @param layer The layer.
+    ///
+    static void compact_layer(DrawLayer& layer)
+    {
+        std::erase(layer.items, nullptr);
+        layer.holes = 0;
+        reindex_layer(layer);
+    }
+
+    /// @brief Group a compacted layer by texture, if it is not already.
+    ///
+    /// @param layer The layer.
+    ///
+    static void batch_layer(DrawLayer& layer)
+    {
+        constexpr auto texture_of = [](const game::GameObject* obj) {
+            return obj->get_batch_texture();
+        };
+
+        if (!std::ranges::is_sorted(layer.items, std::less {}, texture_of)) {
+            std::ranges::stable_sort(layer.items, std::less {}, texture_of);
+            reindex_layer(layer);
+        }
+    }
+
+    /// @brief Store each object's position within its layer.
+    ///
+    /// @param layer The layer.
+    ///
+    static void reindex_layer(DrawLayer& layer)
+    {
+        for (size_t i = 0; i < layer.items.size(); ++i) {
+            layer.items[i]->_draw_slot.index = static_cast<uint32_t>(i);
+        }
+    }
+
+    /// @brief Find the registered type of an object, caching lookups in
+    /// _snapshot_types. Clear the cache before each pass over the objects, as
+    /// types may be registered in between.
+    ///
+    /// @param obj The object.
+    /// @return The type, nullptr if it is not registered.
+    ///
+    const serialize::TypeInfo* find_snapshot_type(const game::GameObject& obj) const
+    {
+        // Scenes have few types, a linear scan over type_info addresses beats
+        // hashing type names for every object
+        const std::type_info* type = &typeid(obj);
+        auto it = std::ranges::find(_snapshot_types, type, &SnapshotType::first);
+        if (it == _snapshot_types.end()) {
+            _snapshot_types.emplace_back(type, serialize::find_type(*type));
+            it = std::prev(_snapshot_types.end());
+        }
+
+        return it->second;
+    }
+
+    /// @brief Remove every object a snapshot holds, pooling what can be
+    /// reused. Objects of unregistered types are not in snapshots and stay.
+    ///
+    void clear_snapshot_objects()
+    {
+        _snapshot_types.clear();
+
+        auto remove = [&](const std::shared_ptr<game::GameObject>& obj) {
+            if (find_snapshot_type(*obj) == nullptr) {
+                return false;
+            }
+
+            remove_from_layer(obj.get());
+            _stats.destroyed++;
+            return true;
+        };
+
+        std::erase_if(_objects, remove);
+        std::erase_if(_obj_to_create, remove);
+
+        // Registries refill on their next query
+        _buckets.clear();
+        _broadphase_stale = true;
+    }
+
+    /// @brief Register an object with every bucket it belongs to.
+    ///
+    /// @param obj The object.
+    ///
+    void add_to_buckets(game::GameObject* obj)
+    {
+        for (auto& [type, bucket] : _buckets) {
+            bucket->try_add(obj);
+        }
+    }
+
+    /// @brief Objects created by one thread during a parallel update.
+    struct alignas(64) StagedObjects {
+        std::vector<std::shared_ptr<game::GameObject>> objects;
+    };
+
+    /// @brief Thread safe objects to update this frame.
+    std::vector<game::GameObject*> _parallel_objects;
+
+    /// @brief Objects created during the parallel update, by thread.
+    std::vector<StagedObjects> _staged;
+
+    /// @brief Whether thread safe objects are being updated in parallel.
+    bool _parallel_update { false };
+
+    /// @brief Thread safe objects per update job.
+    size_t _parallel_grain { DEFAULT_PARALLEL_GRAIN };
+
+    /// @brief Whether thread safe objects may update in parallel.
+    bool _parallel_enabled { true };
+
+    /// @brief Objects by z index, drawn lowest first.
+    std::map<int, DrawLayer> _layers;
+
+    /// @brief Whether layers are grouped by texture.
+    bool _batch_by_texture { false };
+
+    /// @brief Blend factor between the last two updates for drawing.
+    float _interpolation_alpha { 1.0F };
+
+    /// @brief Collision broadphase over the scene's objects.
+    physics::SpatialHash _broadphase;
+
+    /// @brief Whether objects may have moved since the broadphase was built.
+    bool _broadphase_stale { true };
+
+    /// @brief Whether the broadphase was ever queried, so it is built before
+    /// parallel updates.
+    bool _broadphase_used { false };
+
+    /// @brief Object registries by queried type.
+    std::unordered_map<std::type_index, std::unique_ptr<ObjectBucketBase>> _buckets;
+
+    /// @brief Freed object memory kept for reuse, by exact type.
+    std::unordered_map<std::type_index, std::shared_ptr<ObjectPool>> _pools;
+
+    /// @brief Freed objects kept per type.
+    size_t _pool_limit { DEFAULT_OBJECT_POOL_LIMIT };
+
+    /// @brief Object lifetime counters.
+    ObjectStats _stats;
+
+    /// @brief Entities of the scene, stored by component.
+    ecs::World _world;
+
+    /// @brief Whether updates are resimulated ticks after a rollback.
+    bool _resimulating { false };
+
+    /// @brief An object type and its registration, nullptr if unregistered.
+    using SnapshotType = std::pair<const std::type_info*, const serialize::TypeInfo*>;
+
+    /// @brief A type found in a snapshot being loaded, with its pool.
+    struct SeenType {
+        uint64_t hash;
+        const serialize::TypeInfo* info;
+        std::shared_ptr<ObjectPool> pool;
+    };
+
+    /// @brief Type lookups of the current snapshot pass, reused so per-tick
+    /// snapshots do not allocate.
+    mutable std::vector<SnapshotType> _snapshot_types;
+    std::vector<SeenType> _snapshot_seen;
+
     /// @brief Collection of game objects in the scene.
     std::vector<std::shared_ptr<game::GameObject>> _objects;
 
@@ -213,23 +1338,57 @@ public:
     template <typename SceneType, typename... Args>
     void register_scene(const T scene_id, Args&&... args)
     {
-        static_assert(
-            std::is_base_of_v<Scene<T>, SceneType>, "SceneType must be derived from Scene<T>");
-        static_assert(std::is_constructible_v<SceneType, Args...>,
-            "SceneType must be constructible with the given arguments");
+        static_assert(
+            std::is_base_of_v<Scene<T>, SceneType>, "SceneType must be derived from Scene<T>");
+        static_assert(std::is_constructible_v<SceneType, Args...>,
+            "SceneType must be constructible with the given arguments");
+
+        auto scene = std::make_shared<SceneType>(std::forward<Args>(args)...);
+        scene->set_parallel_update(!_deterministic);
+        _scenes[scene_id] = scene;
+    }
+
+    /// @brief Set the next scene. Every scene on the stack is cleaned up and
+    /// replaced by it.
+    ///
+    /// @param scene_id The unique identifier for the scene.
+    ///
+    void set_next_scene(const T scene_id)
+    {
+        _next_scene = scene_id;
+        _has_next_scene = true;
+        _stack_changes.clear();
+    }
+
+    /// @brief Push a scene on top of the current one, such as a pause menu.
+    /// The scene below keeps its state and stops updating until this one is
+    /// popped. Takes effect on the next update.
+    ///
+    /// @param scene_id The unique identifier for the scene.
+    /// @param snapshot Capture the frame below the new scene once and draw
+    /// that, instead of drawing the paused scenes every frame.
+    ///
+    void push_scene(const T scene_id, bool snapshot = true)
+    {
+        _stack_changes.push_back({ StackChange::Action::PUSH, scene_id, snapshot });
+    }
 
-        auto scene = std::make_shared<SceneType>(std::forward<Args>(args)...);
-        _scenes[scene_id] = scene;
+    /// @brief Pop the top scene, cleaning it up and resuming the one below.
+    /// Takes effect on the next update. The bottom scene is never popped, use
+    /// set_next_scene() to replace it.
+    ///
+    void pop_scene()
+    {
+        _stack_changes.push_back({ StackChange::Action::POP, T {}, false });
     }
 
-    /// @brief Set the next scene
+    /// @brief Get the number of scenes on the stack.
     ///
-    /// @param scene_id The unique identifier for the scene.
+    /// @return The stack depth, 0 before the first scene is set.
     ///
-    void set_next_scene(const T scene_id)
+    size_t get_scene_depth() const
     {
-        _next_scene = scene_id;
-        _has_next_scene = true;
+        return _stack.size();
     }
 
     /// @brief Main loop for the scene engine. If this is not enough, or you
@@ -249,20 +1408,46 @@ public:
         auto time_start = std::chrono::high_resolution_clock::now();
         auto last_second = std::chrono::high_resolution_clock::now();
         int frames = 0;
+        uint64_t next_frame_ns = SDL_GetTicksNS();
 
         while (!asw::core::is_exiting()) {
+            // Pump every frame, even ones without an update, so input is
+            // timestamped close to when it happened
+            SDL_PumpEvents();
+
             const auto now = std::chrono::high_resolution_clock::now();
+            const auto now_ns = SDL_GetTicksNS();
             auto delta_time = now - time_start;
             time_start = now;
             lag += std::chrono::duration_cast<std::chrono::nanoseconds>(delta_time);
+            _frame_intervals.push_back(
+                std::chrono::duration<float, std::milli>(delta_time).count());
 
+            int updates = 0;
             while (lag >= this->_timestep) {
-                update(std::chrono::duration<float>(this->_timestep).count());
+                // Too far behind to catch up, drop the backlog rather than
+                // spending ever longer frames on updates
+                if (updates >= _max_updates_per_frame) {
+                    _frame_stats.dropped_updates += lag / this->_timestep;
+                    lag %= this->_timestep;
+                    break;
+                }
+
                 lag -= this->_timestep;
+
+                // Each tick only sees input from its own slice of time
+                const auto lag_ns = static_cast<uint64_t>(lag.count());
+                const auto tick_end = now_ns > lag_ns ? now_ns - lag_ns : 0;
+                update(std::chrono::duration<float>(this->_timestep).count(), tick_end);
+                updates++;
             }
 
-            // Draw
-            draw();
+            // Draw between the last two updates, by how far into the next
+            // update the leftover lag is
+            draw(std::chrono::duration<float>(lag) / this->_timestep);
+
+            const auto frame_end_ns = SDL_GetTicksNS();
+            _frame_work.push_back(static_cast<float>(frame_end_ns - now_ns) / 1'000'000.0F);
 
             frames++;
 
@@ -270,6 +1455,21 @@ public:
                 _fps = frames;
                 frames = 0;
                 last_second = last_second + 1s;
+                update_frame_stats();
+            }
+
+            // Pace to the target frame rate. Deadlines advance by whole
+            // periods so pacing does not drift, unless a frame ran so long
+            // that catching up would mean a burst of frames.
+            if (_target_fps > 0) {
+                const uint64_t period_ns = 1'000'000'000ULL / static_cast<uint64_t>(_target_fps);
+                next_frame_ns += period_ns;
+
+                if (frame_end_ns > next_frame_ns + period_ns) {
+                    next_frame_ns = frame_end_ns;
+                } else {
+                    asw::core::sleep_until(next_frame_ns);
+                }
             }
         }
 
@@ -284,42 +1484,72 @@ public:
     ///
     void cleanup()
     {
-        if (_active_scene != nullptr) {
-            _active_scene->cleanup();
-        }
-
+        clear_stack();
         _scenes.clear();
     }
 
     /// @brief Update the current scene.
     ///
-    /// @param dt The time in seconds since the last update.
+    /// @param dt The time in seconds since the last update. Ignored in
+    /// deterministic mode, where every tick is one timestep.
     ///
     void update(const float dt)
+    {
+        update(dt, UINT64_MAX);
+    }
+
+    /// @brief Update the current scene, consuming only input that happened up
+    /// to a point in time.
+    ///
+    /// @param dt The time in seconds since the last update.
+    /// @param input_until_ns End of the tick's time slice, in SDL_GetTicksNS() time.
+    ///
+    void update(const float dt, const uint64_t input_until_ns)
     {
         if (asw::core::is_exiting()) {
             return;
         }
 
-        asw::core::update();
+        asw::core::update_until(input_until_ns);
         change_scene();
+        apply_stack_changes();
+
+        // Only the top scene runs, the ones below are paused
+        if (_stack.empty()) {
+            return;
+        }
 
-        if (_active_scene != nullptr) {
-            _active_scene->update(dt);
+        auto& scene = *_stack.back().scene;
+        if (_deterministic) {
+            record_tick(scene, _tick);
+            run_tick(scene, _tick);
+            _tick++;
+        } else {
+            scene.update(dt);
         }
     }
 
-    /// @brief Draw the current scene.
+    /// @brief Draw the current scene at its latest state.
     ///
     void draw()
+    {
+        draw(1.0F);
+    }
+
+    /// @brief Draw the current scene, blended between its last two updates.
+    ///
+    /// @param alpha 0 draws the state before the last update, 1 the current
+    /// state. Usually the leftover lag divided by the timestep.
+    ///
+    void draw(const float alpha)
     {
         if (asw::core::is_exiting()) {
             return;
         }
 
-        if (_active_scene != nullptr) {
+        if (!_stack.empty()) {
             asw::display::clear();
-            _active_scene->draw();
+            draw_stack(alpha);
             asw::display::present();
         }
     }
@@ -351,7 +1581,372 @@ public:
         return _fps;
     }
 
+    /// @brief Cap the frame rate of the managed loop. Useful with vsync off,
+    /// where the loop would otherwise draw as fast as it can.
+    ///
+    /// @param fps Target frames per second, 0 for no limit.
+    ///
+    void set_target_fps(int fps)
+    {
+        _target_fps = std::max(fps, 0);
+    }
+
+    /// @brief Get the target frame rate.
+    ///
+    /// @return Target frames per second, 0 if unlimited.
+    ///
+    int get_target_fps() const
+    {
+        return _target_fps;
+    }
+
+    /// @brief Set how many fixed updates may run before each draw. After a
+    /// stall, updates past this cap are dropped instead of run.
+    ///
+    /// @param max_updates Updates per frame, at least 1.
+    ///
+    void set_max_updates_per_frame(int max_updates)
+    {
+        _max_updates_per_frame = std::max(max_updates, 1);
+    }
+
+    /// @brief Get frame time statistics over the last second. Only applies to
+    /// the managed loop.
+    ///
+    /// @return The statistics.
+    ///
+    const FrameStats& get_frame_stats() const
+    {
+        return _frame_stats;
+    }
+
+    /// @brief Run scenes as a deterministic simulation that can be rolled
+    /// back, for rollback netcode or replays.
+    ///
+    /// Every update becomes one tick of exactly one timestep. The default
+    /// random stream is seeded, parallel object updates are turned off, and
+    /// the top scene's snapshot is recorded before each tick. Ticks must get
+    /// their input from the tick input function rather than from devices, so
+    /// resimulated ticks see the same input as the first run. Only snapshot
+    /// state is rolled back: registered objects, the scene's serialize_state()
+    /// and the random stream. Objects of unregistered types are left as they
+    /// are. The entity world is not rolled back either; it steps once per tick
+    /// on the tick's first run and is skipped while ticks are resimulated, so
+    /// use it for presentation and keep simulated state out of both. Rolling
+    /// back recreates registered objects, so look them up with
+    /// get_object_view() instead of holding on to them. Changing scenes clears
+    /// the history.
+    ///
+    /// @param enabled Whether to run deterministically.
+    /// @param seed Seed for the default random stream. Peers must agree on it.
+    /// @param history_ticks How many past ticks can be rolled back to.
+    ///
+    void set_deterministic(
+        bool enabled, uint64_t seed = 0, size_t history_ticks = DEFAULT_ROLLBACK_TICKS)
+    {
+        _deterministic = enabled;
+        _tick = 0;
+        _history_start = 0;
+        _history.clear();
+
+        if (enabled) {
+            asw::random::seed(seed);
+            _history.resize(std::max<size_t>(history_ticks, 1));
+        }
+
+        for (auto& [id, scene] : _scenes) {
+            scene->set_parallel_update(!enabled);
+        }
+    }
+
+    /// @brief Check if the scene manager runs deterministically.
+    ///
+    /// @return true in deterministic mode.
+    ///
+    bool is_deterministic() const
+    {
+        return _deterministic;
+    }
+
+    /// @brief Set the function that feeds input to each tick. It is called
+    /// before the tick is simulated, including when it is resimulated after a
+    /// rollback, and should apply the input recorded for that tick.
+    ///
+    /// @param fn Called as fn(tick).
+    ///
+    void set_tick_input(std::function<void(uint64_t)> fn)
+    {
+        _tick_input = std::move(fn);
+    }
+
+    /// @brief Get the current tick, counted from when deterministic mode was
+    /// enabled.
+    ///
+    /// @return The tick being simulated during updates and rollbacks, the next
+    /// tick to simulate otherwise.
+    ///
+    uint64_t get_tick() const
+    {
+        return _tick;
+    }
+
+    /// @brief Get the oldest tick that can be rolled back to.
+    ///
+    /// @return The oldest tick in the history.
+    ///
+    uint64_t get_oldest_tick() const
+    {
+        const uint64_t window = _history.size();
+        return std::max(_history_start, _tick > window ? _tick - window : 0);
+    }
+
+    /// @brief Roll back to the start of a past tick and resimulate up to the
+    /// current tick, feeding every tick through the tick input function. Call
+    /// it after correcting the recorded input of that tick, and outside of
+    /// scene updates.
+    ///
+    /// @param tick The first tick whose input changed.
+    /// @return true if the scene was resimulated, false if the tick is not in
+    /// the history.
+    ///
+    bool rollback(uint64_t tick)
+    {
+        if (!_deterministic || _stack.empty()) {
+            return false;
+        }
+
+        if (tick == _tick) {
+            return true;
+        }
+
+        if (tick > _tick || tick < get_oldest_tick()) {
+            asw::log::warn("Cannot roll back to tick {}, history holds ticks {} to {}", tick,
+                get_oldest_tick(), _tick);
+            return false;
+        }
+
+        const auto start_ns = SDL_GetTicksNS();
+        auto& scene = *_stack.back().scene;
+
+        if (!restore_tick(scene, tick)) {
+            return false;
+        }
+
+        // The rolled back tick keeps its recording, later ones are recorded
+        // again with the corrected input
+        const uint64_t now = _tick;
+        scene.set_resimulating(true);
+        for (uint64_t t = tick; t < now; ++t) {
+            if (t != tick) {
+                record_tick(scene, t);
+            }
+
+            _tick = t;
+            run_tick(scene, t);
+        }
+        scene.set_resimulating(false);
+        _tick = now;
+
+        const auto elapsed_ns = SDL_GetTicksNS() - start_ns;
+        _rollback_stats.rollbacks++;
+        _rollback_stats.last_ticks = now - tick;
+        _rollback_stats.resimulated_ticks += _rollback_stats.last_ticks;
+        _rollback_stats.last_ms = static_cast<float>(elapsed_ns) / 1'000'000.0F;
+        _rollback_stats.total_ms += _rollback_stats.last_ms;
+
+        if (_rollback_budget.count() > 0
+            && elapsed_ns > static_cast<uint64_t>(_rollback_budget.count())) {
+            _rollback_stats.over_budget++;
+        }
+
+        return true;
+    }
+
+    /// @brief Get the checksum of a recorded tick, to compare with a peer and
+    /// detect desyncs.
+    ///
+    /// @param tick The tick.
+    /// @return Checksum of the state at the start of the tick, if recorded.
+    ///
+    std::optional<uint64_t> get_tick_checksum(uint64_t tick) const
+    {
+        if (!has_tick(tick)) {
+            return std::nullopt;
+        }
+
+        return _history[tick % _history.size()].checksum;
+    }
+
+    /// @brief Get the recorded state of a tick, to find where two runs
+    /// diverged with serialize::find_first_difference().
+    ///
+    /// @param tick The tick.
+    /// @return The random state followed by the scene snapshot, empty if not
+    /// recorded. Valid until the tick is recorded over.
+    ///
+    std::span<const uint8_t> get_tick_state(uint64_t tick) const
+    {
+        if (!has_tick(tick)) {
+            return {};
+        }
+
+        return _history[tick % _history.size()].state.data();
+    }
+
+    /// @brief Set how long a rollback should take at most. Rollbacks are
+    /// always completed, ones over budget are counted in the stats.
+    ///
+    /// @param budget Time budget, 0 for none.
+    ///
+    void set_rollback_budget(std::chrono::nanoseconds budget)
+    {
+        _rollback_budget = budget;
+    }
+
+    /// @brief Get rollback counters.
+    ///
+    /// @return The counters.
+    ///
+    const RollbackStats& get_rollback_stats() const
+    {
+        return _rollback_stats;
+    }
+
 private:
+    /// @brief Summarize the frame times of the last second.
+    ///
+    void update_frame_stats()
+    {
+        summarize_times(_frame_intervals, _frame_stats.interval);
+        summarize_times(_frame_work, _frame_stats.work);
+    }
+
+    /// @brief Summarize a set of durations, then clear them.
+    ///
+    /// @param times The durations, in milliseconds.
+    /// @param out The summary to fill.
+    ///
+    static void summarize_times(std::vector<float>& times, FrameStats::Times& out)
+    {
+        if (times.empty()) {
+            return;
+        }
+
+        const auto [min, max] = std::ranges::minmax(times);
+        float total = 0.0F;
+        for (const float time : times) {
+            total += time;
+        }
+
+        out.min_ms = min;
+        out.max_ms = max;
+        out.avg_ms = total / static_cast<float>(times.size());
+
+        const auto p99 = (times.size() * 99) / 100;
+        std::ranges::nth_element(times, times.begin() + p99);
+        out.p99_ms = times[p99];
+
+        times.clear();
+    }
+
+    /// @brief A scene on the stack.
+    struct StackEntry {
+        std::shared_ptr<Scene<T>> scene;
+
+        // Frame captured when the scene above was pushed, if requested
+        asw::Texture snapshot;
+    };
+
+    /// @brief A queued push or pop.
+    struct StackChange {
+        enum class Action { PUSH, POP };
+
+        Action action;
+        T scene_id;
+        bool snapshot;
+    };
+
+    /// @brief Recorded state at the start of a tick.
+    struct TickRecord {
+        // Random stream state, then the scene snapshot. Reused across ticks.
+        serialize::BinaryWriter state;
+        uint64_t checksum { 0 };
+    };
+
+    /// @brief Check if a tick is in the history.
+    ///
+    /// @param tick The tick.
+    /// @return true if it can be rolled back to.
+    ///
+    bool has_tick(uint64_t tick) const
+    {
+        return _deterministic && tick < _tick && tick >= get_oldest_tick();
+    }
+
+    /// @brief Record the state at the start of a tick.
+    ///
+    /// @param scene The scene being simulated.
+    /// @param tick The tick.
+    ///
+    void record_tick(const Scene<T>& scene, uint64_t tick)
+    {
+        auto& record = _history[tick % _history.size()];
+        record.state.clear();
+
+        for (const uint64_t word : asw::random::get_stream().get_state()) {
+            record.state.write_u64(word);
+        }
+
+        scene.save_snapshot(record.state);
+        record.checksum = serialize::checksum(record.state.data());
+    }
+
+    /// @brief Restore the state recorded at the start of a tick.
+    ///
+    /// @param scene The scene being simulated.
+    /// @param tick The tick.
+    /// @return true on success.
+    ///
+    bool restore_tick(Scene<T>& scene, uint64_t tick)
+    {
+        const auto data = _history[tick % _history.size()].state.data();
+        serialize::BinaryReader reader(data);
+
+        asw::random::State random_state;
+        for (auto& word : random_state) {
+            word = reader.read_u64();
+        }
+
+        if (!reader.ok() || !scene.load_snapshot(data.subspan(reader.position()))) {
+            asw::log::error("Failed to restore tick {}", tick);
+            return false;
+        }
+
+        asw::random::get_stream().set_state(random_state);
+        return true;
+    }
+
+    /// @brief Feed a tick its input and simulate it.
+    ///
+    /// @param scene The scene being simulated.
+    /// @param tick The tick.
+    ///
+    void run_tick(Scene<T>& scene, uint64_t tick)
+    {
+        if (_tick_input) {
+            _tick_input(tick);
+        }
+
+        scene.update(std::chrono::duration<float>(_timestep).count());
+    }
+
+    /// @brief Forget recorded ticks, for when the simulated scene changes.
+    ///
+    void clear_history()
+    {
+        _history_start = _tick;
+    }
+
     /// @brief Change the current scene to the next scene.
     ///
     void change_scene()
@@ -360,20 +1955,149 @@ private:
             return;
         }
 
-        if (_active_scene != nullptr) {
-            _active_scene->cleanup();
-        }
+        clear_stack();
+        clear_history();
 
         if (auto it = _scenes.find(_next_scene); it != _scenes.end()) {
-            _active_scene = it->second;
-            _active_scene->init();
+            _stack.push_back({ it->second, nullptr });
+            it->second->init();
         }
 
         _has_next_scene = false;
     }
 
-    /// @brief The current scene of the scene engine.
-    std::shared_ptr<Scene<T>> _active_scene { nullptr };
+    /// @brief Apply queued pushes and pops, in order.
+    ///
+    void apply_stack_changes()
+    {
+        if (!_stack_changes.empty()) {
+            clear_history();
+        }
+
+        for (const auto& change : _stack_changes) {
+            if (change.action == StackChange::Action::PUSH) {
+                push_now(change.scene_id, change.snapshot);
+            } else {
+                pop_now();
+            }
+        }
+
+        _stack_changes.clear();
+    }
+
+    /// @brief Pause the top scene and push another over it.
+    ///
+    /// @param scene_id The scene to push.
+    /// @param snapshot Whether to capture the current frame for the paused
+    /// scene.
+    ///
+    void push_now(const T scene_id, bool snapshot)
+    {
+        auto it = _scenes.find(scene_id);
+        if (it == _scenes.end()) {
+            asw::log::warn("Cannot push unregistered scene");
+            return;
+        }
+
+        if (std::ranges::any_of(
+                _stack, [&](const StackEntry& entry) { return entry.scene == it->second; })) {
+            asw::log::warn("Cannot push a scene that is already on the stack");
+            return;
+        }
+
+        if (!_stack.empty()) {
+            auto& below = _stack.back();
+            below.scene->on_pause();
+
+            if (snapshot) {
+                below.snapshot = capture_stack();
+            }
+        }
+
+        _stack.push_back({ it->second, nullptr });
+        it->second->init();
+    }
+
+    /// @brief Clean up the top scene and resume the one below.
+    ///
+    void pop_now()
+    {
+        if (_stack.size() <= 1) {
+            asw::log::warn("Cannot pop the bottom scene");
+            return;
+        }
+
+        _stack.back().scene->cleanup();
+        _stack.pop_back();
+
+        auto& top = _stack.back();
+        top.snapshot = nullptr;
+        top.scene->on_resume();
+    }
+
+    /// @brief Clean up every scene on the stack, top first.
+    ///
+    void clear_stack()
+    {
+        while (!_stack.empty()) {
+            _stack.back().scene->cleanup();
+            _stack.pop_back();
+        }
+    }
+
+    /// @brief Draw the visible part of the stack. Scenes under the highest
+    /// snapshot are covered by it and skipped.
+    ///
+    /// @param alpha Interpolation alpha for the top scene. Paused scenes are
+    /// drawn at their latest state.
+    ///
+    void draw_stack(const float alpha)
+    {
+        size_t first = 0;
+        for (size_t i = _stack.size() - 1; i > 0; --i) {
+            if (_stack[i - 1].snapshot != nullptr) {
+                const auto size = asw::display::get_logical_size();
+                asw::draw::stretch_sprite(_stack[i - 1].snapshot,
+                    asw::Quad<float>(0.0F, 0.0F, static_cast<float>(size.x),
+                        static_cast<float>(size.y)));
+                first = i;
+                break;
+            }
+        }
+
+        for (size_t i = first; i < _stack.size(); ++i) {
+            auto& scene = *_stack[i].scene;
+            scene.set_interpolation_alpha(i + 1 == _stack.size() ? alpha : 1.0F);
+            scene.draw();
+        }
+    }
+
+    /// @brief Render the current stack into a texture.
+    ///
+    /// @return The texture, or nullptr without a renderer.
+    ///
+    asw::Texture capture_stack()
+    {
+        if (asw::display::get_renderer() == nullptr) {
+            return nullptr;
+        }
+
+        const auto size = asw::display::get_logical_size();
+        auto texture = asw::assets::create_texture(size.x, size.y);
+
+        asw::display::set_render_target(texture);
+        asw::display::clear();
+        draw_stack(1.0F);
+        asw::display::reset_render_target();
+
+        return texture;
+    }
+
+    /// @brief Scenes being run, the top one is updated.
+    std::vector<StackEntry> _stack;
+
+    /// @brief Pushes and pops to apply on the next update.
+    std::vector<StackChange> _stack_changes;
 
     /// @brief The next scene of the scene engine.
     T _next_scene;
@@ -390,6 +2114,41 @@ private:
     /// @brief FPS Counter for managed loop.
     int _fps { 0 };
 
+    /// @brief Frame rate cap of the managed loop, 0 for none.
+    int _target_fps { 0 };
+
+    /// @brief Fixed updates allowed before each draw.
+    int _max_updates_per_frame { DEFAULT_MAX_UPDATES_PER_FRAME };
+
+    /// @brief Frame time statistics for the managed loop.
+    FrameStats _frame_stats;
+
+    /// @brief Frame intervals and work times of the current second, in
+    /// milliseconds.
+    std::vector<float> _frame_intervals;
+    std::vector<float> _frame_work;
+
+    /// @brief Whether updates run as deterministic ticks.
+    bool _deterministic { false };
+
+    /// @brief Next tick to simulate.
+    uint64_t _tick { 0 };
+
+    /// @brief Recorded ticks, indexed by tick modulo the size.
+    std::vector<TickRecord> _history;
+
+    /// @brief First tick recorded for the current scene.
+    uint64_t _history_start { 0 };
+
+    /// @brief Feeds recorded input to each tick.
+    std::function<void(uint64_t)> _tick_input;
+
+    /// @brief Time a rollback should take at most, 0 for none.
+    std::chrono::nanoseconds _rollback_budget { 0 };
+
+    /// @brief Rollback counters.
+    RollbackStats _rollback_stats;
+
 #ifdef __EMSCRIPTEN__
     /// @brief Pointer to the current instance of the scene manager.
     static SceneManager<T>* instance_;
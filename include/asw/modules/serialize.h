@@ -0,0 +1,295 @@
+/// @file serialize.h
+/// @author Allan Legemaate (alegemaate@gmail.com)
+/// @brief Binary serialization of game state
+/// @date 2026-10-18
+///
+/// @copyright Copyright (c) 2026
+///
+/// Compact little endian buffers for save states, quick restarts and test
+/// fixtures. Game objects write their state through
+/// GameObject::serialize(), scenes snapshot all of their objects at once.
+///
+/// Example:
+/// @code
+///   class Player : public asw::game::Sprite {
+///   public:
+///       void serialize(asw::serialize::BinaryWriter& writer) const override
+///       {
+///           Sprite::serialize(writer);
+///           writer.write_i32(health);
+///       }
+///
+///       void deserialize(asw::serialize::BinaryReader& reader) override
+///       {
+///           Sprite::deserialize(reader);
+///           health = reader.read_i32();
+///       }
+///
+///       int health { 100 };
+///   };
+///
+///   asw::serialize::register_type<Player>("player");
+///
+///   auto checkpoint = save_snapshot();
+///   ...
+///   load_snapshot(checkpoint);
+/// @endcode
+
+#ifndef ASW_SERIALIZE_H
+#define ASW_SERIALIZE_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <typeindex>
+#include <vector>
+
+#include "./geometry.h"
+
+namespace asw::game {
+class GameObject;
+} // namespace asw::game
+
+namespace asw::serialize {
+
+/// @brief Appends values to a growing byte buffer, little endian.
+///
+class BinaryWriter {
+public:
+    void write_u8(uint8_t value);
+    void write_u16(uint16_t value);
+    void write_u32(uint32_t value);
+    void write_u64(uint64_t value);
+    void write_i32(int32_t value);
+    void write_f32(float value);
+    void write_bool(bool value);
+
+    /// @brief Write a string, prefixed with its length.
+    ///
+    /// @param value The string.
+    ///
+    void write_string(std::string_view value);
+
+    /// @brief Write raw bytes, without a length.
+    ///
+    /// @param data The bytes.
+    ///
+    void write_bytes(std::span<const uint8_t> data);
+
+    void write_vec2(const Vec2<float>& value);
+    void write_quad(const Quad<float>& value);
+
+    /// @brief Overwrite a u32 written earlier, such as a length prefix.
+    ///
+    /// @param offset Offset of the value in the buffer.
+    /// @param value The new value.
+    ///
+    void patch_u32(size_t offset, uint32_t value);
+
+    /// @brief Reserve space up front.
+    ///
+    /// @param size Total bytes expected.
+    ///
+    void reserve(size_t size);
+
+    /// @brief Get the number of bytes written.
+    ///
+    /// @return The size in bytes.
+    ///
+    size_t size() const;
+
+    /// @brief Get the written bytes.
+    ///
+    /// @return The bytes, valid until the next write.
+    ///
+    std::span<const uint8_t> data() const;
+
+    /// @brief Move the written bytes out, leaving the writer empty.
+    ///
+    /// @return The buffer.
+    ///
+    std::vector<uint8_t> take();
+
+    /// @brief Discard the written bytes, keeping the buffer for reuse.
+    ///
+    void clear();
+
+private:
+    /// @brief Claim the next bytes, growing the buffer if needed.
+    ///
+    /// @param size Number of bytes.
+    /// @return Pointer to them.
+    ///
+    uint8_t* grow(size_t size);
+
+    template <typename T> void append(T value);
+
+    // Grown ahead of size_, so most writes are a bounds check and a copy
+    std::vector<uint8_t> buffer_;
+    size_t size_ { 0 };
+};
+
+/// @brief Reads values back from a byte buffer. Reading past the end, or
+/// calling fail(), puts the reader in a failed state where every read returns
+/// zero, so callers can check ok() once at the end.
+///
+class BinaryReader {
+public:
+    /// @brief Create a reader.
+    ///
+    /// @param data The bytes to read. Must outlive the reader.
+    ///
+    explicit BinaryReader(std::span<const uint8_t> data);
+
+    uint8_t read_u8();
+    uint16_t read_u16();
+    uint32_t read_u32();
+    uint64_t read_u64();
+    int32_t read_i32();
+    float read_f32();
+    bool read_bool();
+    std::string read_string();
+    Vec2<float> read_vec2();
+    Quad<float> read_quad();
+
+    /// @brief Read raw bytes.
+    ///
+    /// @param size Number of bytes.
+    /// @return The bytes, empty on failure.
+    ///
+    std::span<const uint8_t> read_bytes(size_t size);
+
+    /// @brief Skip bytes.
+    ///
+    /// @param size Number of bytes.
+    ///
+    void skip(size_t size);
+
+    /// @brief Mark the data as invalid.
+    ///
+    void fail();
+
+    /// @brief Check that every read so far succeeded.
+    ///
+    /// @return true if no read failed.
+    ///
+    bool ok() const;
+
+    /// @brief Get the read position.
+    ///
+    /// @return Offset in bytes.
+    ///
+    size_t position() const;
+
+    /// @brief Get the number of unread bytes.
+    ///
+    /// @return Bytes remaining.
+    ///
+    size_t remaining() const;
+
+private:
+    /// @brief Claim the next bytes.
+    ///
+    /// @param size Number of bytes.
+    /// @return Pointer to them, nullptr if there are not enough.
+    ///
+    const uint8_t* claim(size_t size);
+
+    std::span<const uint8_t> data_;
+    size_t cursor_ { 0 };
+    bool ok_ { true };
+};
+
+/// @brief How to recreate objects of a registered type.
+struct TypeInfo {
+    std::string name;
+
+    // The registered type, filled in on registration
+    std::type_index type { typeid(void) };
+
+    // Hash of the name, stored in snapshots
+    uint64_t hash { 0 };
+
+    // Make a new default constructed object
+    std::function<std::shared_ptr<game::GameObject>()> create;
+
+};
+
+/// @brief Hash a type name the way snapshots store it.
+///
+/// @param name The name.
+/// @return 64-bit FNV-1a hash.
+///
+constexpr uint64_t hash_type_name(std::string_view name)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/// @brief Hash a buffer, for cheap comparison of snapshots.
+///
+/// @param data The bytes.
+/// @return 64-bit hash. Stable across runs and platforms.
+///
+uint64_t checksum(std::span<const uint8_t> data);
+
+/// @brief Find where two buffers start to differ.
+///
+/// @param a The first buffer.
+/// @param b The second buffer.
+/// @return Offset of the first differing byte, the shorter size if one is a
+/// prefix of the other, or SIZE_MAX if they are equal.
+///
+size_t find_first_difference(std::span<const uint8_t> a, std::span<const uint8_t> b);
+
+/// @brief Register a type so snapshots can recreate it.
+///
+/// @param type The type.
+/// @param info How to recreate it. The type and hash are filled in.
+///
+void register_type(std::type_index type, TypeInfo info);
+
+/// @brief Register a game object type so snapshots can recreate it.
+///
+/// @tparam ObjectType Default constructible type derived from GameObject.
+/// @param name Name stored in snapshots. Keep it stable across versions.
+///
+template <typename ObjectType> void register_type(std::string_view name)
+{
+    static_assert(std::is_base_of_v<game::GameObject, ObjectType>,
+        "ObjectType must be derived from GameObject");
+    static_assert(std::is_default_constructible_v<ObjectType>,
+        "ObjectType must be default constructible");
+
+    TypeInfo info;
+    info.name = name;
+    info.create = [] { return std::make_shared<ObjectType>(); };
+
+    register_type(typeid(ObjectType), std::move(info));
+}
+
+/// @brief Find a registered type.
+///
+/// @param type The type.
+/// @return The type's info, nullptr if not registered.
+///
+const TypeInfo* find_type(std::type_index type);
+
+/// @brief Find a registered type by the hash of its name.
+///
+/// @param hash The hash.
+/// @return The type's info, nullptr if not registered.
+///
+const TypeInfo* find_type(uint64_t hash);
+
+} // namespace asw::serialize
+
+#endif // ASW_SERIALIZE_H
@@ -9,26 +9,189 @@
 #ifndef ASW_SOUND_H
 #define ASW_SOUND_H
 
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "./geometry.h"
 #include "./types.h"
 
 namespace asw::sound {
 
+/// @brief Default distance at which positional sounds fall silent.
+constexpr float DEFAULT_AUDIBLE_RADIUS = 800.0F;
+
+/// @brief Default number of voices available for sound effects.
+constexpr uint32_t DEFAULT_VOICE_COUNT = 16;
+
+/// @brief Sample rate of the mixer in frames per second.
+constexpr int MIXER_FREQUENCY = 44100;
+
+/// @brief Number of output channels of the mixer.
+constexpr int MIXER_CHANNELS = 2;
+
+/// @brief Where the mixer sends its output.
+enum class Backend {
+    Device, // Stream to the default playback device in real time
+    Offline, // Render on demand with render(), as fast as possible
+};
+
+/// @brief Strategy used to free a voice when every voice is busy.
+enum class StealMode {
+    None, // Drop the new sound
+    Oldest, // Stop the voice that started playing first
+    Quietest, // Stop the voice with the lowest volume
+};
+
+/// @brief Handle to a sound playing on a voice.
+///
+/// @details Handles stay cheap to copy and go stale once the voice is reused
+/// for another sound, so it is always safe to keep one around after playback
+/// has finished.
+///
+struct Voice {
+    uint32_t index { 0 };
+    uint32_t generation { 0 };
+
+    /// @brief Check if the handle refers to a voice at all.
+    ///
+    /// @return True if the handle was returned by a successful play call.
+    ///
+    bool is_valid() const
+    {
+        return generation != 0;
+    }
+};
+
 /// @brief Initialize the sound module. Called automatically by asw::core::init().
 ///
+/// @details The offline backend needs no audio device, which makes it usable
+/// on headless machines for tests and benchmarks. Call it directly before
+/// asw::core::init() to use it.
+///
+/// @param backend The output backend (default: Backend::Device).
 /// @return True if initialization was successful, false otherwise.
 ///
-bool _init();
+bool _init(Backend backend = Backend::Device);
 
 /// @brief Shut down the sound module. Called automatically by asw::core::shutdown().
 ///
 void _shutdown();
 
+/// @brief Advance the sound module by one tick. Called automatically by asw::core::update().
+///
+/// @details Plays issued between two calls count as the same tick for sample
+/// policy coalescing. Attenuation and panning of all positional voices are
+/// recomputed here in a single pass.
+///
+void _update();
+
+/// @brief Drop the policy state of a sample that is being destroyed, so a
+/// later sample at the same address does not inherit it. Called by the
+/// deleter of samples loaded through asw::assets.
+///
+/// @param audio The sample's audio.
+///
+void _forget_sample(const MIX_Audio* audio);
+
+/// @brief Check if the mixer renders offline.
+///
+/// @return True if the mixer was created with Backend::Offline.
+///
+bool is_offline();
+
+/// @brief Mix audio into a buffer. Only available with the offline backend.
+///
+/// @details Output is interleaved signed 16-bit stereo at MIXER_FREQUENCY.
+/// The buffer length must be a multiple of MIXER_CHANNELS.
+///
+/// @param buffer The buffer to fill.
+/// @return True if the buffer was filled.
+///
+bool render(std::span<int16_t> buffer);
+
+/// @brief Mix a number of seconds of audio. Only available with the offline backend.
+///
+/// @param seconds Duration to render.
+/// @return The rendered samples, empty on failure.
+///
+std::vector<int16_t> render(float seconds);
+
+/// @brief Mix a number of seconds of audio into a WAV file. Only available
+/// with the offline backend.
+///
+/// @param path Path of the file to write.
+/// @param seconds Duration to render.
+/// @return True if the file was written.
+///
+bool render_to_wav(const std::string& path, float seconds);
+
 /// @brief Get the SDL mixer device.
 ///
 /// @return Pointer to the MIX_Mixer, or nullptr if not initialized.
 ///
 MIX_Mixer* get_mixer();
 
+/// @brief Playback limits applied to every play of a specific sample.
+///
+struct SamplePolicy {
+    // Maximum voices playing this sample at once (0 = unlimited)
+    uint32_t max_instances { 0 };
+
+    // Minimum time in seconds between two plays of this sample
+    float min_interval_s { 0.0F };
+
+    // Merge plays from the same tick into one voice with their volumes summed
+    bool coalesce { false };
+};
+
+/// @brief Set the playback policy of a sample.
+///
+/// @details Plays rejected by the policy return an invalid voice handle,
+/// except for coalesced plays which return the voice they were merged into.
+///
+/// @param sample The sample to configure.
+/// @param policy The policy to apply.
+///
+void set_sample_policy(const asw::Sample& sample, const SamplePolicy& policy);
+
+/// @brief Remove the playback policy of a sample.
+///
+/// @param sample The sample to reset.
+///
+void clear_sample_policy(const asw::Sample& sample);
+
+/// @brief Set the number of voices available for sound effects.
+///
+/// @details If the mixer is already running, all playing sound effects are
+/// stopped and the voice pool is rebuilt.
+///
+/// @param count Number of voices (at least 1).
+///
+void set_voice_count(uint32_t count);
+
+/// @brief Get the number of voices available for sound effects.
+///
+/// @return The voice count.
+///
+uint32_t get_voice_count();
+
+/// @brief Get the number of voices currently playing.
+///
+/// @return The active voice count.
+///
+uint32_t get_active_voice_count();
+
+/// @brief Set how a voice is chosen when all voices are busy.
+///
+/// @details Only voices with a priority lower than or equal to the new sound
+/// are candidates for stealing.
+///
+/// @param mode The steal mode (default: StealMode::Oldest).
+///
+void set_steal_mode(StealMode mode);
+
 /// @brief Play a sample.
 ///
 /// @param sample Sample to play
@@ -37,8 +200,100 @@ MIX_Mixer* get_mixer();
 /// and 1.0 is full right.
 /// @param loop Whether to loop the sample (false = no loop, true = infinite
 /// loop).
+/// @param priority Priority of the sound. Higher priority sounds may steal
+/// voices from lower priority ones.
+/// @return Handle to the voice, invalid if the sound was dropped.
+///
+Voice play(const asw::Sample& sample, float volume = 1.0F, float pan = 0.5F, bool loop = false,
+    int priority = 0);
+
+/// @brief Play a sample from a position in the world.
+///
+/// @details Volume falls off linearly with distance from the listener and
+/// panning follows the horizontal offset. Voices beyond the audible radius
+/// are virtualized: they stop being mixed until they come back in range.
+/// Virtual one-shots keep time, resuming at the point they would have
+/// reached and finishing when their length has passed. Looping voices pause
+/// and pick up where they left off.
+///
+/// @param sample Sample to play
+/// @param position Position of the emitter.
+/// @param volume Playback volume (0.0 - 1.0).
+/// @param loop Whether to loop the sample.
+/// @param priority Priority of the sound.
+/// @return Handle to the voice, invalid if the sound was dropped.
+///
+Voice play_at(const asw::Sample& sample, const asw::Vec2<float>& position, float volume = 1.0F,
+    bool loop = false, int priority = 0);
+
+/// @brief Move the emitter of a positional voice.
+///
+/// @param voice The voice handle.
+/// @param position New position of the emitter.
 ///
-void play(const asw::Sample& sample, float volume = 1.0F, float pan = 0.5F, bool loop = false);
+void set_voice_position(Voice voice, const asw::Vec2<float>& position);
+
+/// @brief Check if a positional voice is virtualized (out of range).
+///
+/// @param voice The voice handle.
+/// @return True if the voice is playing but not being mixed.
+///
+bool is_voice_virtual(Voice voice);
+
+/// @brief Set the listener position used for positional sounds.
+///
+/// @param position The listener position.
+///
+void set_listener(const asw::Vec2<float>& position);
+
+/// @brief Place the listener at the center of a camera view.
+///
+/// @param view The visible area of the world.
+///
+void set_listener(const asw::Quad<float>& view);
+
+/// @brief Get the listener position.
+///
+/// @return The listener position.
+///
+asw::Vec2<float> get_listener();
+
+/// @brief Set the distance at which positional sounds fall silent.
+///
+/// @param radius The audible radius in world units.
+///
+void set_audible_radius(float radius);
+
+/// @brief Set the volume of a playing voice.
+///
+/// @param voice The voice handle.
+/// @param volume Playback volume (0.0 - 1.0).
+///
+void set_voice_volume(Voice voice, float volume);
+
+/// @brief Set the panning of a playing voice.
+///
+/// @details Positional voices recompute their panning every tick, so this
+/// only lasts until the next update for them.
+///
+/// @param voice The voice handle.
+/// @param pan Panning (-1.0 - 1.0).
+///
+void set_voice_pan(Voice voice, float pan);
+
+/// @brief Stop a playing voice.
+///
+/// @param voice The voice handle.
+/// @param fade_out_s Fade-out duration in seconds.
+///
+void stop_voice(Voice voice, float fade_out_s = 0.0F);
+
+/// @brief Check if a voice is still playing its sound.
+///
+/// @param voice The voice handle.
+/// @return True if the handle is current and the voice is playing.
+///
+bool is_voice_playing(Voice voice);
 
 /// @brief Play a music sample.
 ///
@@ -48,6 +303,31 @@ void play(const asw::Sample& sample, float volume = 1.0F, float pan = 0.5F, bool
 ///
 void play_music(const asw::Music& sample, float volume = 1.0F, float fade_in_s = 0.0F);
 
+/// @brief Switch to another music track without a gap.
+///
+/// @details The new track starts on the idle music deck while the current one
+/// fades out over the same number of frames. If nothing is playing, this is
+/// the same as play_music() with a fade-in. Use
+/// asw::assets::load_music_async() to open the next track ahead of time.
+///
+/// @param sample Music to switch to.
+/// @param duration_s Crossfade duration in seconds.
+/// @param volume Playback volume (0.0 - 1.0).
+///
+void crossfade_music(const asw::Music& sample, float duration_s, float volume = 1.0F);
+
+/// @brief Set where a music track loops back to after it ends.
+///
+/// @details The part before the loop point plays once as an intro, then
+/// playback loops over the rest of the track. Applies the next time the music
+/// is started.
+///
+/// @param sample The music to configure.
+/// @param loop_start_frame Loop start in sample frames of the music (0 = loop
+/// the whole track).
+///
+void set_music_loop_point(const asw::Music& sample, int64_t loop_start_frame);
+
 /// @brief Stop the currently playing music.
 ///
 void stop_music(float fade_out_s = 0.0F);
@@ -4,10 +4,30 @@
 #include <unordered_map>
 #include <vector>
 
+#include "./asw/modules/log.h"
+
 namespace {
 
+/// @brief Kind of raw input a binding reads from.
+enum class SourceKind : uint8_t {
+    Key,
+    MouseButton,
+    ControllerButton,
+    ControllerAxis,
+};
+
+/// @brief A binding flattened at bind time, so evaluation is a plain switch.
+struct CompiledBinding {
+    SourceKind kind { SourceKind::Key };
+    uint32_t code { 0 };
+    uint32_t controller_index { 0 };
+    float threshold { 0.0F };
+    bool positive_direction { true };
+};
+
 struct ActionData {
-    std::vector<asw::input::ActionBinding> bindings;
+    std::vector<CompiledBinding> bindings;
+    uint32_t set { 0 };
 
     bool pressed { false };
     bool released { false };
@@ -16,105 +36,321 @@ struct ActionData {
 
     /// Tracks the down state from the previous frame to derive axis transitions.
     bool prev_down { false };
+
+    /// Already queued for evaluation this frame.
+    bool dirty { false };
 };
 
-std::unordered_map<std::string, ActionData> action_map;
+struct ActionSetData {
+    bool enabled { true };
+};
 
-// ---------------------------------------------------------------------------
-// Per-binding query helpers
-// ---------------------------------------------------------------------------
+/// @brief Transparent string hash so lookups by string_view don't allocate.
+struct NameHash {
+    using is_transparent = void;
 
-/// Returns true if the binding is currently active, and updates out_strength.
-bool binding_is_down(const asw::input::ActionBinding& binding, float& out_strength)
+    size_t operator()(std::string_view name) const
+    {
+        return std::hash<std::string_view> {}(name);
+    }
+};
+
+template <typename T> using NameMap = std::unordered_map<std::string, T, NameHash, std::equal_to<>>;
+
+/// @brief Action storage. Ids are stable for the lifetime of the action map.
+std::vector<ActionData> actions;
+NameMap<uint32_t> action_ids;
+
+/// @brief Action ids by hashed name, for ActionKey lookups.
+std::unordered_map<uint64_t, uint32_t> action_hashes;
+
+/// @brief Action sets. Set 0 is the default set and is always present.
+std::vector<ActionSetData> action_sets { ActionSetData {} };
+NameMap<uint32_t> action_set_ids { { "", 0 } };
+
+/// @brief Reverse index from raw input source to the actions bound to it.
+/// Only actions in enabled sets are indexed.
+std::unordered_map<uint32_t, std::vector<uint32_t>> source_index;
+bool index_stale { false };
+
+/// @brief Actions to evaluate on the next update.
+std::vector<uint32_t> dirty_actions;
+
+/// @brief Actions that reported a press or release last update and need
+/// those one-frame flags cleared.
+std::vector<uint32_t> transient_actions;
+std::vector<uint32_t> next_transient_actions;
+
+constexpr uint32_t source_key(SourceKind kind, uint32_t controller_index, uint32_t code)
+{
+    return (static_cast<uint32_t>(kind) << 24) | ((controller_index & 0xFF) << 16)
+        | (code & 0xFFFF);
+}
+
+uint32_t source_key(const CompiledBinding& binding)
+{
+    return source_key(binding.kind, binding.controller_index, binding.code);
+}
+
+CompiledBinding compile_binding(const asw::input::ActionBinding& binding)
 {
     return std::visit(
-        [&out_strength](const auto& b) -> bool {
+        [](const auto& b) -> CompiledBinding {
             using T = std::decay_t<decltype(b)>;
 
             if constexpr (std::is_same_v<T, asw::input::KeyBinding>) {
-                if (asw::input::get_key(b.key)) {
-                    out_strength = std::max(out_strength, 1.0F);
-                    return true;
-                }
-                return false;
+                return { .kind = SourceKind::Key, .code = static_cast<uint32_t>(b.key) };
 
             } else if constexpr (std::is_same_v<T, asw::input::MouseButtonBinding>) {
-                if (asw::input::get_mouse_button(b.button)) {
-                    out_strength = std::max(out_strength, 1.0F);
-                    return true;
-                }
-                return false;
+                return { .kind = SourceKind::MouseButton,
+                    .code = static_cast<uint32_t>(b.button) };
 
             } else if constexpr (std::is_same_v<T, asw::input::ControllerButtonBinding>) {
-                if (asw::input::get_controller_button(b.controller_index, b.button)) {
-                    out_strength = std::max(out_strength, 1.0F);
-                    return true;
-                }
-                return false;
-
-            } else if constexpr (std::is_same_v<T, asw::input::ControllerAxisBinding>) {
-                const float val = asw::input::get_controller_axis(b.controller_index, b.axis);
-                const float effective = b.positive_direction ? val : -val;
-                if (effective >= b.threshold) {
-                    out_strength = std::max(out_strength, effective);
-                    return true;
-                }
-
-                return false;
-            }
+                return { .kind = SourceKind::ControllerButton,
+                    .code = static_cast<uint32_t>(b.button),
+                    .controller_index = b.controller_index };
 
-            return false;
+            } else {
+                return { .kind = SourceKind::ControllerAxis,
+                    .code = static_cast<uint32_t>(b.axis),
+                    .controller_index = b.controller_index,
+                    .threshold = b.threshold,
+                    .positive_direction = b.positive_direction };
+            }
         },
         binding);
 }
 
+void mark_dirty(uint32_t id)
+{
+    auto& action = actions[id];
+    if (!action.dirty) {
+        action.dirty = true;
+        dirty_actions.push_back(id);
+    }
+}
+
+void mark_all_dirty()
+{
+    for (uint32_t id = 0; id < actions.size(); ++id) {
+        if (action_sets[actions[id].set].enabled) {
+            mark_dirty(id);
+        }
+    }
+}
+
+/// @brief Rebuild the reverse index after bindings or set states change.
+/// Every indexed action is re-evaluated, so new bindings pick up input that
+/// is already held.
+void compile_index()
+{
+    for (auto& [key, ids] : source_index) {
+        ids.clear();
+    }
+
+    for (uint32_t id = 0; id < actions.size(); ++id) {
+        const auto& action = actions[id];
+        if (!action_sets[action.set].enabled) {
+            continue;
+        }
+
+        for (const auto& binding : action.bindings) {
+            auto& ids = source_index[source_key(binding)];
+            if (std::find(ids.begin(), ids.end(), id) == ids.end()) {
+                ids.push_back(id);
+            }
+        }
+    }
+
+    index_stale = false;
+    mark_all_dirty();
+}
+
+void mark_source(SourceKind kind, uint32_t controller_index, uint32_t code)
+{
+    if (index_stale) {
+        compile_index();
+    }
+
+    const auto it = source_index.find(source_key(kind, controller_index, code));
+    if (it == source_index.end()) {
+        return;
+    }
+
+    for (const auto id : it->second) {
+        mark_dirty(id);
+    }
+}
+
+uint32_t get_or_create_action(std::string_view name)
+{
+    if (const auto it = action_ids.find(name); it != action_ids.end()) {
+        return it->second;
+    }
+
+    const auto id = static_cast<uint32_t>(actions.size());
+    actions.emplace_back();
+    action_ids.emplace(name, id);
+
+    if (!action_hashes.try_emplace(asw::input::hash_action_name(name), id).second) {
+        asw::log::error("Action name hash collision: {}", name);
+    }
+
+    return id;
+}
+
+uint32_t get_or_create_set(std::string_view name)
+{
+    if (const auto it = action_set_ids.find(name); it != action_set_ids.end()) {
+        return it->second;
+    }
+
+    const auto id = static_cast<uint32_t>(action_sets.size());
+    action_sets.emplace_back();
+    action_set_ids.emplace(name, id);
+    return id;
+}
+
+const ActionData* find_action(asw::input::ActionId id)
+{
+    return id.index < actions.size() ? &actions[id.index] : nullptr;
+}
+
+const ActionData* find_action(std::string_view name)
+{
+    return find_action(asw::input::get_action_id(name));
+}
+
+const ActionData* find_action(asw::input::ActionKey key)
+{
+    return find_action(asw::input::get_action_id(key));
+}
+
+void clear_state(ActionData& action)
+{
+    action.pressed = false;
+    action.released = false;
+    action.down = false;
+    action.strength = 0.0F;
+    action.prev_down = false;
+}
+
+// ---------------------------------------------------------------------------
+// Per-binding query helpers
+// ---------------------------------------------------------------------------
+
+/// Returns true if the binding is currently active, and updates out_strength.
+bool binding_is_down(const CompiledBinding& binding, float& out_strength)
+{
+    switch (binding.kind) {
+    case SourceKind::Key:
+        if (asw::input::get_key(static_cast<asw::input::Key>(binding.code))) {
+            out_strength = std::max(out_strength, 1.0F);
+            return true;
+        }
+        return false;
+
+    case SourceKind::MouseButton:
+        if (asw::input::get_mouse_button(static_cast<asw::input::MouseButton>(binding.code))) {
+            out_strength = std::max(out_strength, 1.0F);
+            return true;
+        }
+        return false;
+
+    case SourceKind::ControllerButton:
+        if (asw::input::get_controller_button(binding.controller_index,
+                static_cast<asw::input::ControllerButton>(binding.code))) {
+            out_strength = std::max(out_strength, 1.0F);
+            return true;
+        }
+        return false;
+
+    case SourceKind::ControllerAxis: {
+        const float val = asw::input::get_controller_axis(
+            binding.controller_index, static_cast<asw::input::ControllerAxis>(binding.code));
+        const float effective = binding.positive_direction ? val : -val;
+        if (effective >= binding.threshold) {
+            out_strength = std::max(out_strength, effective);
+            return true;
+        }
+        return false;
+    }
+    }
+
+    return false;
+}
+
 /// Returns true if the binding was pressed this frame (digital sources only).
 /// Axis bindings return false here — their transitions are handled via prev_down.
-bool binding_is_pressed(const asw::input::ActionBinding& binding)
+bool binding_is_pressed(const CompiledBinding& binding)
 {
-    return std::visit(
-        [](const auto& b) -> bool {
-            using T = std::decay_t<decltype(b)>;
+    switch (binding.kind) {
+    case SourceKind::Key:
+        return asw::input::get_key_down(static_cast<asw::input::Key>(binding.code));
 
-            if constexpr (std::is_same_v<T, asw::input::KeyBinding>) {
-                return asw::input::get_key_down(b.key);
+    case SourceKind::MouseButton:
+        return asw::input::get_mouse_button_down(
+            static_cast<asw::input::MouseButton>(binding.code));
 
-            } else if constexpr (std::is_same_v<T, asw::input::MouseButtonBinding>) {
-                return asw::input::get_mouse_button_down(b.button);
+    case SourceKind::ControllerButton:
+        return asw::input::get_controller_button_down(
+            binding.controller_index, static_cast<asw::input::ControllerButton>(binding.code));
 
-            } else if constexpr (std::is_same_v<T, asw::input::ControllerButtonBinding>) {
-                return asw::input::get_controller_button_down(b.controller_index, b.button);
+    case SourceKind::ControllerAxis:
+        return false;
+    }
 
-            } else {
-                // ControllerAxisBinding: transition handled by prev_down in update_actions.
-                return false;
-            }
-        },
-        binding);
+    return false;
 }
 
 /// Returns true if the binding was released this frame (digital sources only).
-bool binding_is_released(const asw::input::ActionBinding& binding)
+bool binding_is_released(const CompiledBinding& binding)
 {
-    return std::visit(
-        [](const auto& b) -> bool {
-            using T = std::decay_t<decltype(b)>;
+    switch (binding.kind) {
+    case SourceKind::Key:
+        return asw::input::get_key_up(static_cast<asw::input::Key>(binding.code));
 
-            if constexpr (std::is_same_v<T, asw::input::KeyBinding>) {
-                return asw::input::get_key_up(b.key);
+    case SourceKind::MouseButton:
+        return asw::input::get_mouse_button_up(static_cast<asw::input::MouseButton>(binding.code));
 
-            } else if constexpr (std::is_same_v<T, asw::input::MouseButtonBinding>) {
-                return asw::input::get_mouse_button_up(b.button);
+    case SourceKind::ControllerButton:
+        return asw::input::get_controller_button_up(
+            binding.controller_index, static_cast<asw::input::ControllerButton>(binding.code));
 
-            } else if constexpr (std::is_same_v<T, asw::input::ControllerButtonBinding>) {
-                return asw::input::get_controller_button_up(b.controller_index, b.button);
+    case SourceKind::ControllerAxis:
+        return false;
+    }
 
-            } else {
-                // ControllerAxisBinding: transition handled by prev_down in update_actions.
-                return false;
-            }
-        },
-        binding);
+    return false;
+}
+
+void evaluate(ActionData& action)
+{
+    bool any_down = false;
+    bool any_pressed = false;
+    bool any_released = false;
+    float max_strength = 0.0F;
+
+    for (const auto& binding : action.bindings) {
+        any_down |= binding_is_down(binding, max_strength);
+        any_pressed |= binding_is_pressed(binding);
+        any_released |= binding_is_released(binding);
+    }
+
+    // Derive press / release transitions for axis bindings (and as a
+    // fallback for any binding that doesn't supply its own signals).
+    if (any_down && !action.prev_down) {
+        any_pressed = true;
+    }
+    if (!any_down && action.prev_down) {
+        any_released = true;
+    }
+
+    action.pressed = any_pressed;
+    action.released = any_released;
+    action.down = any_down;
+    action.strength = max_strength;
+    action.prev_down = any_down;
 }
 
 } // namespace
@@ -123,72 +359,238 @@ bool binding_is_released(const asw::input::ActionBinding& binding)
 // Public API
 // ---------------------------------------------------------------------------
 
-void asw::input::bind_action(std::string_view name, asw::input::ActionBinding binding)
+asw::input::ActionId asw::input::bind_action(
+    std::string_view name, asw::input::ActionBinding binding)
+{
+    const auto id = get_or_create_action(name);
+    actions[id].bindings.push_back(compile_binding(binding));
+    index_stale = true;
+    return ActionId { id };
+}
+
+asw::input::ActionId asw::input::get_action_id(std::string_view name)
 {
-    action_map[std::string(name)].bindings.push_back(binding);
+    const auto it = action_ids.find(name);
+    return it != action_ids.end() ? ActionId { it->second } : ActionId {};
+}
+
+asw::input::ActionId asw::input::get_action_id(asw::input::ActionKey key)
+{
+    const auto it = action_hashes.find(key.hash);
+    return it != action_hashes.end() ? ActionId { it->second } : ActionId {};
 }
 
 void asw::input::unbind_action(std::string_view name)
 {
-    action_map.erase(std::string(name));
+    const auto it = action_ids.find(name);
+    if (it == action_ids.end()) {
+        return;
+    }
+
+    // The slot is kept so ids stay stable, it is simply left with no bindings
+    auto& action = actions[it->second];
+    action.bindings.clear();
+    clear_state(action);
+    index_stale = true;
 }
 
 void asw::input::clear_actions()
 {
-    action_map.clear();
+    actions.clear();
+    action_ids.clear();
+    action_hashes.clear();
+    action_sets.assign(1, ActionSetData {});
+    action_set_ids = { { "", 0 } };
+    source_index.clear();
+    dirty_actions.clear();
+    transient_actions.clear();
+    next_transient_actions.clear();
+    index_stale = false;
+}
+
+void asw::input::set_action_set(std::string_view name, std::string_view set)
+{
+    const auto id = get_or_create_action(name);
+    const auto set_id = get_or_create_set(set);
+
+    auto& action = actions[id];
+    if (action.set == set_id) {
+        return;
+    }
+
+    action.set = set_id;
+    if (!action_sets[set_id].enabled) {
+        clear_state(action);
+    }
+    index_stale = true;
+}
+
+void asw::input::enable_action_set(std::string_view set)
+{
+    auto& data = action_sets[get_or_create_set(set)];
+    if (!data.enabled) {
+        data.enabled = true;
+        index_stale = true;
+    }
+}
+
+void asw::input::disable_action_set(std::string_view set)
+{
+    const auto set_id = get_or_create_set(set);
+    auto& data = action_sets[set_id];
+    if (!data.enabled) {
+        return;
+    }
+
+    data.enabled = false;
+    for (auto& action : actions) {
+        if (action.set == set_id) {
+            clear_state(action);
+        }
+    }
+    index_stale = true;
+}
+
+bool asw::input::is_action_set_enabled(std::string_view set)
+{
+    const auto it = action_set_ids.find(set);
+    return it == action_set_ids.end() || action_sets[it->second].enabled;
 }
 
 bool asw::input::get_action_down(std::string_view name)
 {
-    auto it = action_map.find(std::string(name));
-    return it != action_map.end() && it->second.pressed;
+    const auto* action = find_action(name);
+    return action != nullptr && action->pressed;
 }
 
 bool asw::input::get_action_up(std::string_view name)
 {
-    auto it = action_map.find(std::string(name));
-    return it != action_map.end() && it->second.released;
+    const auto* action = find_action(name);
+    return action != nullptr && action->released;
 }
 
 bool asw::input::get_action(std::string_view name)
 {
-    auto it = action_map.find(std::string(name));
-    return it != action_map.end() && it->second.down;
+    const auto* action = find_action(name);
+    return action != nullptr && action->down;
 }
 
 float asw::input::get_action_strength(std::string_view name)
 {
-    auto it = action_map.find(std::string(name));
-    return it != action_map.end() ? it->second.strength : 0.0F;
+    const auto* action = find_action(name);
+    return action != nullptr ? action->strength : 0.0F;
+}
+
+bool asw::input::get_action_down(asw::input::ActionId id)
+{
+    const auto* action = find_action(id);
+    return action != nullptr && action->pressed;
+}
+
+bool asw::input::get_action_down(asw::input::ActionKey key)
+{
+    const auto* action = find_action(key);
+    return action != nullptr && action->pressed;
+}
+
+bool asw::input::get_action_up(asw::input::ActionId id)
+{
+    const auto* action = find_action(id);
+    return action != nullptr && action->released;
+}
+
+bool asw::input::get_action_up(asw::input::ActionKey key)
+{
+    const auto* action = find_action(key);
+    return action != nullptr && action->released;
+}
+
+bool asw::input::get_action(asw::input::ActionId id)
+{
+    const auto* action = find_action(id);
+    return action != nullptr && action->down;
+}
+
+bool asw::input::get_action(asw::input::ActionKey key)
+{
+    const auto* action = find_action(key);
+    return action != nullptr && action->down;
+}
+
+float asw::input::get_action_strength(asw::input::ActionId id)
+{
+    const auto* action = find_action(id);
+    return action != nullptr ? action->strength : 0.0F;
+}
+
+float asw::input::get_action_strength(asw::input::ActionKey key)
+{
+    const auto* action = find_action(key);
+    return action != nullptr ? action->strength : 0.0F;
 }
 
 void asw::input::update_actions()
 {
-    for (auto& [name, action] : action_map) {
-        bool any_down = false;
-        bool any_pressed = false;
-        bool any_released = false;
-        float max_strength = 0.0F;
+    if (index_stale) {
+        compile_index();
+    }
 
-        for (const auto& binding : action.bindings) {
-            any_down |= binding_is_down(binding, max_strength);
-            any_pressed |= binding_is_pressed(binding);
-            any_released |= binding_is_released(binding);
-        }
+    // Press and release only last one frame. Anything not re-evaluated below
+    // saw no input change, so clearing them is all it needs.
+    for (const auto id : transient_actions) {
+        actions[id].pressed = false;
+        actions[id].released = false;
+    }
+    transient_actions.clear();
 
-        // Derive press / release transitions for axis bindings (and as a
-        // fallback for any binding that doesn't supply its own signals).
-        if (any_down && !action.prev_down) {
-            any_pressed = true;
+    for (const auto id : dirty_actions) {
+        auto& action = actions[id];
+        action.dirty = false;
+
+        if (!action_sets[action.set].enabled) {
+            continue;
         }
-        if (!any_down && action.prev_down) {
-            any_released = true;
+
+        evaluate(action);
+
+        if (action.pressed || action.released) {
+            next_transient_actions.push_back(id);
         }
+    }
+    dirty_actions.clear();
+
+    std::swap(transient_actions, next_transient_actions);
+}
+
+// ---------------------------------------------------------------------------
+// Hooks
+// ---------------------------------------------------------------------------
 
-        action.pressed = any_pressed;
-        action.released = any_released;
-        action.down = any_down;
-        action.strength = max_strength;
-        action.prev_down = any_down;
+void asw::input::_action_key_changed(SDL_Scancode scancode)
+{
+    mark_source(SourceKind::Key, 0, static_cast<uint32_t>(scancode));
+}
+
+void asw::input::_action_mouse_button_changed(uint8_t button)
+{
+    mark_source(SourceKind::MouseButton, 0, button);
+}
+
+void asw::input::_action_controller_button_changed(uint32_t index, uint32_t button)
+{
+    mark_source(SourceKind::ControllerButton, index, button);
+}
+
+void asw::input::_action_controller_axis_changed(uint32_t index, uint32_t axis)
+{
+    mark_source(SourceKind::ControllerAxis, index, axis);
+}
+
+void asw::input::_action_controllers_changed()
+{
+    if (index_stale) {
+        compile_index();
+    } else {
+        mark_all_dirty();
     }
 }
@@ -4,10 +4,17 @@
 #include <SDL3_image/SDL_image.h>
 #include <SDL3_mixer/SDL_mixer.h>
 #include <SDL3_ttf/SDL_ttf.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 
 #include "./asw/modules/display.h"
+#include "./asw/modules/log.h"
 #include "./asw/modules/sound.h"
 #include "./asw/modules/types.h"
 #include "./asw/modules/util.h"
@@ -17,6 +24,88 @@ std::unordered_map<std::string, asw::Texture> textures;
 std::unordered_map<std::string, asw::Font> fonts;
 std::unordered_map<std::string, asw::Sample> samples;
 std::unordered_map<std::string, asw::Music> music;
+
+#ifndef __EMSCRIPTEN__
+/// @brief Background thread for slow asset IO. The job system is for short
+/// compute work and its waits run queued jobs inline, so loads stay out of it.
+///
+class Loader {
+public:
+    Loader() = default;
+    Loader(const Loader&) = delete;
+    Loader& operator=(const Loader&) = delete;
+    Loader(Loader&&) = delete;
+    Loader& operator=(Loader&&) = delete;
+
+    // Joinable threads would otherwise terminate the program at exit
+    ~Loader()
+    {
+        stop();
+    }
+
+    /// @brief Queue a load, starting the thread on first use.
+    ///
+    /// @param task The load.
+    ///
+    void push(std::function<void()> task)
+    {
+        const std::scoped_lock lock(mutex_);
+        tasks_.push_back(std::move(task));
+
+        if (!thread_.joinable()) {
+            stopping_ = false;
+            thread_ = std::thread([this] { run(); });
+        }
+
+        wake_.notify_one();
+    }
+
+    /// @brief Finish queued loads, then stop the thread.
+    ///
+    void stop()
+    {
+        {
+            const std::scoped_lock lock(mutex_);
+            stopping_ = true;
+        }
+
+        wake_.notify_one();
+
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+private:
+    void run()
+    {
+        std::unique_lock lock(mutex_);
+
+        while (true) {
+            wake_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+
+            if (tasks_.empty()) {
+                return;
+            }
+
+            auto task = std::move(tasks_.front());
+            tasks_.pop_front();
+
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<std::function<void()>> tasks_;
+    std::thread thread_;
+    bool stopping_ { false };
+};
+
+Loader loader;
+#endif
 } // namespace
 
 // --- Paths ---
@@ -159,6 +248,7 @@ asw::Sample asw::assets::load_sample(const std::string& filename)
     }
 
     return { temp, [](MIX_Audio* a) {
+                asw::sound::_forget_sample(a);
                 if (asw::sound::get_mixer() != nullptr) {
                     MIX_DestroyAudio(a);
                 }
@@ -219,6 +309,38 @@ asw::Music asw::assets::load_music(const std::string& filename, const std::strin
     return mus;
 }
 
+std::future<asw::Music> asw::assets::load_music_async(const std::string& filename, bool predecode)
+{
+    const auto full_path = get_path(filename);
+
+    const auto load = [full_path, predecode]() -> asw::Music {
+        MIX_Audio* temp = MIX_LoadAudio(asw::sound::get_mixer(), full_path.c_str(), predecode);
+
+        if (temp == nullptr) {
+            asw::log::error("Failed to load music: {}", full_path);
+            return nullptr;
+        }
+
+        return { temp, [](MIX_Audio* a) {
+                    if (asw::sound::get_mixer() != nullptr) {
+                        MIX_DestroyAudio(a);
+                    }
+                } };
+    };
+
+#ifdef __EMSCRIPTEN__
+    // No worker threads without pthreads, load when the result is requested
+    return std::async(std::launch::deferred, load);
+#else
+    // A future from std::async blocks in its destructor until the load is
+    // done, so fulfil a promise from the loader thread instead
+    auto promise = std::make_shared<std::promise<asw::Music>>();
+    auto future = promise->get_future();
+    loader.push([promise, load] { promise->set_value(load()); });
+    return future;
+#endif
+}
+
 asw::Music asw::assets::get_music(const std::string& key)
 {
     auto it = music.find(key);
@@ -243,3 +365,10 @@ void asw::assets::clear_all()
     samples.clear();
     music.clear();
 }
+
+void asw::assets::_shutdown()
+{
+#ifndef __EMSCRIPTEN__
+    loader.stop();
+#endif
+}
@@ -4,23 +4,384 @@
 #include <SDL3_mixer/SDL_mixer.h>
 #include <SDL3_ttf/SDL_ttf.h>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <format>
+#include <vector>
 
 #include "./asw/modules/action.h"
 #include "./asw/modules/assets.h"
 #include "./asw/modules/display.h"
 #include "./asw/modules/input.h"
+#include "./asw/modules/jobs.h"
 #include "./asw/modules/log.h"
+#include "./asw/modules/replay.h"
 #include "./asw/modules/sound.h"
 #include "./asw/modules/util.h"
 
 namespace {
 bool exiting = false;
+
+using asw::input::InputEvent;
+
+/// @brief Capacity of the timestamped input queue. Must be a power of two.
+constexpr size_t INPUT_QUEUE_CAPACITY = 1024;
+
+/// @brief Bytes of text kept per queued text input event, including the
+/// terminator. Longer text is cut at a character boundary.
+constexpr size_t QUEUED_TEXT_SIZE = 64;
+
+/// @brief A queued event. Text is copied in, since SDL frees the event's
+/// string once it is polled.
+struct QueuedEvent {
+    SDL_Event event;
+    std::array<char, QUEUED_TEXT_SIZE> text;
+};
+
+/// @brief Copy text into a fixed buffer, cutting it at a UTF-8 character
+/// boundary if it does not fit.
+void copy_text(std::array<char, QUEUED_TEXT_SIZE>& out, const char* text)
+{
+    size_t size = text != nullptr ? std::strlen(text) : 0;
+    if (size >= out.size()) {
+        size = out.size() - 1;
+        while (size > 0 && (static_cast<uint8_t>(text[size]) & 0xC0U) == 0x80U) {
+            size--;
+        }
+    }
+
+    std::copy_n(text, size, out.data());
+    out[size] = '\0';
+}
+
+/// @brief Lock-free single producer, single consumer ring of SDL events.
+///
+/// The producer is the SDL event watch, which SDL serializes. The consumer is
+/// asw::core::update_until(), which only pops events inside its time slice.
+template <size_t N> class EventRing {
+    static_assert((N & (N - 1)) == 0, "EventRing capacity must be a power of two");
+
+public:
+    bool push(const SDL_Event& event)
+    {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == N) {
+            dropped_.store(true, std::memory_order_relaxed);
+            return false;
+        }
+
+        auto& entry = events_[tail & (N - 1)];
+        entry.event = event;
+        if (event.type == SDL_EVENT_TEXT_INPUT) {
+            copy_text(entry.text, event.text.text);
+        }
+
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    const QueuedEvent* front() const
+    {
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+
+        return &events_[head & (N - 1)];
+    }
+
+    void pop()
+    {
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    void clear()
+    {
+        head_.store(tail_.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    bool take_dropped()
+    {
+        return dropped_.exchange(false, std::memory_order_relaxed);
+    }
+
+private:
+    std::array<QueuedEvent, N> events_ {};
+    std::atomic<size_t> head_ { 0 };
+    std::atomic<size_t> tail_ { 0 };
+    std::atomic<bool> dropped_ { false };
+};
+
+EventRing<INPUT_QUEUE_CAPACITY> input_queue;
+
+/// @brief True once the event watch feeds input_queue. Until then the poll
+/// loop feeds it.
+bool watching_events = false;
+
+/// @brief When the event watch was added. Controller connections SDL queued
+/// before then never reached the watch.
+uint64_t watching_since_ns = 0;
+
+/// @brief End of the time slice being processed by the current update.
+uint64_t tick_time = 0;
+
+/// @brief Length of each OS sleep in sleep_until().
+constexpr uint64_t SLEEP_CHUNK_NS = 1'000'000;
+
+/// @brief Weight of each new sample in the sleep duration estimate.
+constexpr double SLEEP_ESTIMATE_WEIGHT = 0.05;
+
+/// @brief Moving mean and variance of how long a sleep chunk really takes.
+/// Starts pessimistic and converges on the scheduler's actual granularity.
+double sleep_mean_ns = 2'000'000.0;
+double sleep_variance_ns = 0.0;
+
+/// @brief Input events that go through the timestamped queue, so a tick sees
+/// them in the order they happened.
+bool is_queued_input(const SDL_Event& e)
+{
+    switch (e.type) {
+    case SDL_EVENT_TEXT_INPUT:
+    case SDL_EVENT_GAMEPAD_ADDED:
+    case SDL_EVENT_GAMEPAD_REMOVED:
+    case SDL_EVENT_KEY_DOWN:
+    case SDL_EVENT_KEY_UP:
+    case SDL_EVENT_MOUSE_BUTTON_DOWN:
+    case SDL_EVENT_MOUSE_BUTTON_UP:
+    case SDL_EVENT_MOUSE_MOTION:
+    case SDL_EVENT_MOUSE_WHEEL:
+    case SDL_EVENT_GAMEPAD_AXIS_MOTION:
+    case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
+    case SDL_EVENT_GAMEPAD_BUTTON_UP:
+        return true;
+
+    default:
+        return false;
+    }
 }
 
+bool SDLCALL watch_event(void* /*userdata*/, SDL_Event* event)
+{
+    if (is_queued_input(*event)) {
+        input_queue.push(*event);
+    }
+    return true;
+}
+
+/// @brief Mouse motion gathered during one update. Dispatched as a single
+/// event so coordinates are only converted once, with the summed relative motion.
+struct PendingMotion {
+    bool active { false };
+    SDL_Event last {};
+    float delta_x { 0.0F };
+    float delta_y { 0.0F };
+};
+
+/// @brief Latest value of a controller axis seen during one update.
+struct PendingAxis {
+    SDL_JoystickID id { 0 };
+    uint8_t axis { 0 };
+    int16_t value { 0 };
+    uint64_t timestamp { 0 };
+};
+
+PendingMotion pending_motion;
+std::vector<PendingAxis> pending_axes;
+
+void queue_motion(const SDL_Event& e)
+{
+    pending_motion.active = true;
+    pending_motion.last = e;
+    pending_motion.delta_x += e.motion.xrel;
+    pending_motion.delta_y += e.motion.yrel;
+
+    // Sub-frame samples are opt in, as each needs its own conversion
+    if (asw::input::get_mouse_sample_capacity() > 0) {
+        float x = e.motion.x;
+        float y = e.motion.y;
+
+        if (auto* r = asw::display::get_renderer(); r != nullptr) {
+            SDL_RenderCoordinatesFromWindow(r, e.motion.x, e.motion.y, &x, &y);
+        }
+
+        asw::input::_mouse_sample(x, y, e.motion.timestamp);
+    }
+}
+
+void flush_motion()
+{
+    if (!pending_motion.active) {
+        return;
+    }
+
+    auto& e = pending_motion.last;
+    e.motion.xrel = pending_motion.delta_x;
+    e.motion.yrel = pending_motion.delta_y;
+
+    // Ensure scale is applied to mouse coordinates
+    if (auto* r = asw::display::get_renderer(); r != nullptr) {
+        SDL_ConvertEventToRenderCoordinates(r, &e);
+    }
+
+    asw::input::_dispatch({ .type = InputEvent::Type::MouseMotion,
+        .x = e.motion.x,
+        .y = e.motion.y,
+        .delta_x = e.motion.xrel,
+        .delta_y = e.motion.yrel,
+        .timestamp = e.motion.timestamp });
+
+    pending_motion = {};
+}
+
+void queue_axis(const SDL_Event& e)
+{
+    for (auto& pending : pending_axes) {
+        if (pending.id == e.gaxis.which && pending.axis == e.gaxis.axis) {
+            pending.value = e.gaxis.value;
+            pending.timestamp = e.gaxis.timestamp;
+            return;
+        }
+    }
+
+    pending_axes.push_back({ .id = e.gaxis.which,
+        .axis = e.gaxis.axis,
+        .value = e.gaxis.value,
+        .timestamp = e.gaxis.timestamp });
+}
+
+void flush_axes()
+{
+    for (const auto& pending : pending_axes) {
+        asw::input::_dispatch({ .type = InputEvent::Type::ControllerAxisMotion,
+            .code = pending.id,
+            .index = pending.axis,
+            .x = static_cast<float>(pending.value),
+            .timestamp = pending.timestamp });
+    }
+
+    pending_axes.clear();
+}
+
+void handle_input_event(const QueuedEvent& queued)
+{
+    const SDL_Event& e = queued.event;
+
+    switch (e.type) {
+    case SDL_EVENT_TEXT_INPUT: {
+        asw::input::_dispatch({ .type = InputEvent::Type::Text,
+            .timestamp = e.text.timestamp,
+            .text = queued.text.data() });
+        break;
+    }
+
+    case SDL_EVENT_GAMEPAD_ADDED: {
+        asw::input::_dispatch({ .type = InputEvent::Type::ControllerAdded,
+            .code = e.gdevice.which,
+            .timestamp = e.gdevice.timestamp });
+        break;
+    }
+
+    case SDL_EVENT_GAMEPAD_REMOVED: {
+        // A removed controller's last axis values arrive before it leaves
+        flush_axes();
+        asw::input::_dispatch({ .type = InputEvent::Type::ControllerRemoved,
+            .code = e.gdevice.which,
+            .timestamp = e.gdevice.timestamp });
+        break;
+    }
+
+    case SDL_EVENT_KEY_DOWN: {
+        if (!e.key.repeat) {
+            asw::input::_dispatch({ .type = InputEvent::Type::KeyDown,
+                .code = static_cast<uint32_t>(e.key.scancode),
+                .timestamp = e.key.timestamp });
+        }
+        break;
+    }
+
+    case SDL_EVENT_KEY_UP: {
+        if (!e.key.repeat) {
+            asw::input::_dispatch({ .type = InputEvent::Type::KeyUp,
+                .code = static_cast<uint32_t>(e.key.scancode),
+                .timestamp = e.key.timestamp });
+        }
+        break;
+    }
+
+    case SDL_EVENT_MOUSE_BUTTON_DOWN: {
+        // Clicks land at the position they happened at
+        flush_motion();
+        asw::input::_dispatch({ .type = InputEvent::Type::MouseButtonDown,
+            .code = e.button.button,
+            .timestamp = e.button.timestamp });
+        break;
+    }
+
+    case SDL_EVENT_MOUSE_BUTTON_UP: {
+        flush_motion();
+        asw::input::_dispatch({ .type = InputEvent::Type::MouseButtonUp,
+            .code = e.button.button,
+            .timestamp = e.button.timestamp });
+        break;
+    }
+
+    case SDL_EVENT_MOUSE_MOTION: {
+        queue_motion(e);
+        break;
+    }
+
+    case SDL_EVENT_MOUSE_WHEEL: {
+        asw::input::_dispatch({ .type = InputEvent::Type::MouseWheel,
+            .y = e.wheel.y,
+            .timestamp = e.wheel.timestamp });
+        break;
+    }
+
+    case SDL_EVENT_GAMEPAD_AXIS_MOTION: {
+        queue_axis(e);
+        break;
+    }
+
+    case SDL_EVENT_GAMEPAD_BUTTON_DOWN: {
+        // Presses see the stick where it was when they happened
+        flush_axes();
+        asw::input::_dispatch({ .type = InputEvent::Type::ControllerButtonDown,
+            .code = e.gbutton.which,
+            .index = e.gbutton.button,
+            .timestamp = e.gbutton.timestamp });
+        break;
+    }
+
+    case SDL_EVENT_GAMEPAD_BUTTON_UP: {
+        flush_axes();
+        asw::input::_dispatch({ .type = InputEvent::Type::ControllerButtonUp,
+            .code = e.gbutton.which,
+            .index = e.gbutton.button,
+            .timestamp = e.gbutton.timestamp });
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+} // namespace
+
 void asw::core::update()
+{
+    update_until(UINT64_MAX);
+}
+
+void asw::core::update_until(uint64_t end_ns)
 {
     asw::input::reset();
+    asw::sound::_update();
+    asw::input::_begin_tick();
+
+    tick_time = std::min(end_ns, SDL_GetTicksNS());
 
     SDL_Event e;
 
@@ -53,83 +414,79 @@ void asw::core::update()
             break;
         }
 
-        case SDL_EVENT_KEY_DOWN: {
-            if (!e.key.repeat) {
-                asw::input::_key_down(e.key.scancode);
-            }
-            break;
-        }
-
-        case SDL_EVENT_KEY_UP: {
-            if (!e.key.repeat) {
-                asw::input::_key_up(e.key.scancode);
+        case SDL_EVENT_GAMEPAD_ADDED: {
+            // Pads connected at startup were queued before the watch existed
+            if (!watching_events || e.gdevice.timestamp < watching_since_ns) {
+                input_queue.push(e);
             }
             break;
         }
 
-        case SDL_EVENT_MOUSE_BUTTON_DOWN: {
-            asw::input::_mouse_button_down(e.button.button);
+        case SDL_EVENT_QUIT: {
+            exit();
             break;
         }
 
-        case SDL_EVENT_MOUSE_BUTTON_UP: {
-            asw::input::_mouse_button_up(e.button.button);
+        default:
+            // Without the watch, queue input here so it still goes through
+            // the same time slicing
+            if (!watching_events && is_queued_input(e)) {
+                input_queue.push(e);
+            }
             break;
         }
+    }
 
-        case SDL_EVENT_MOUSE_MOTION: {
-            // Ensure scale is applied to mouse coordinates
-            auto* r = asw::display::get_renderer();
-            if (r != nullptr) {
-                SDL_ConvertEventToRenderCoordinates(r, &e);
-            }
+    if (input_queue.take_dropped()) {
+        asw::log::warn("Input queue full, events were dropped");
+    }
 
-            asw::input::_mouse_motion(e.motion.x, e.motion.y, e.motion.xrel, e.motion.yrel);
+    // Consume only the events that happened before the end of this slice,
+    // later ones belong to the next tick
+    while (const auto* next = input_queue.front()) {
+        if (next->event.common.timestamp > end_ns) {
             break;
         }
 
-        case SDL_EVENT_MOUSE_WHEEL: {
-            asw::input::_mouse_wheel(e.wheel.y);
-            break;
-        }
+        handle_input_event(*next);
+        input_queue.pop();
+    }
 
-        case SDL_EVENT_GAMEPAD_AXIS_MOTION: {
-            asw::input::_controller_axis_motion(e.gaxis.which, e.gaxis.axis, e.gaxis.value);
-            break;
-        }
+    flush_motion();
+    flush_axes();
 
-        case SDL_EVENT_GAMEPAD_BUTTON_DOWN: {
-            asw::input::_controller_button_down(e.gbutton.which, e.gbutton.button);
-            break;
-        }
+    asw::input::_end_tick();
+}
 
-        case SDL_EVENT_GAMEPAD_BUTTON_UP: {
-            asw::input::_controller_button_up(e.gbutton.which, e.gbutton.button);
-            break;
-        }
+uint64_t asw::core::get_tick_time()
+{
+    return tick_time;
+}
 
-        case SDL_EVENT_GAMEPAD_ADDED: {
-            asw::input::_controller_added(e.gdevice.which);
-            break;
-        }
+void asw::core::sleep_until(uint64_t deadline_ns)
+{
+    uint64_t now = SDL_GetTicksNS();
 
-        case SDL_EVENT_GAMEPAD_REMOVED: {
-            asw::input::_controller_removed(e.gdevice.which);
+    // Sleep while a whole chunk, plus its usual overshoot, still fits
+    while (now < deadline_ns) {
+        const double budget = sleep_mean_ns + std::sqrt(sleep_variance_ns);
+        if (static_cast<double>(deadline_ns - now) <= budget) {
             break;
         }
 
-        case SDL_EVENT_TEXT_INPUT: {
-            asw::input::_append_text(e.text.text);
-            break;
-        }
+        SDL_DelayNS(SLEEP_CHUNK_NS);
 
-        case SDL_EVENT_QUIT: {
-            exit();
-        }
+        const uint64_t after = SDL_GetTicksNS();
+        const double diff = static_cast<double>(after - now) - sleep_mean_ns;
+        const double weighted = SLEEP_ESTIMATE_WEIGHT * diff;
+        sleep_mean_ns += weighted;
+        sleep_variance_ns = (1.0 - SLEEP_ESTIMATE_WEIGHT) * (sleep_variance_ns + weighted * diff);
+        now = after;
+    }
 
-        default:
-            break;
-        }
+    // Spin out the rest
+    while (SDL_GetTicksNS() < deadline_ns) {
+        SDL_CPUPauseInstruction();
     }
 }
 
@@ -147,6 +504,9 @@ void asw::core::init(int width, int height, int scale)
         asw::util::abort_on_error("Sound initialization failed");
     }
 
+    watching_since_ns = SDL_GetTicksNS();
+    watching_events = SDL_AddEventWatch(watch_event, nullptr);
+
     asw::display::_init(width, height, scale);
 }
 
@@ -164,6 +524,9 @@ void asw::core::init_opengl(int width, int height, int scale)
         asw::util::abort_on_error("Sound initialization failed");
     }
 
+    watching_since_ns = SDL_GetTicksNS();
+    watching_events = SDL_AddEventWatch(watch_event, nullptr);
+
     // --- Set GL attributes before creating the window ---
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3); // Request OpenGL 3.x
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
@@ -195,6 +558,16 @@ void asw::core::exit()
 
 void asw::core::shutdown()
 {
+    if (watching_events) {
+        SDL_RemoveEventWatch(watch_event, nullptr);
+        watching_events = false;
+    }
+    input_queue.clear();
+
+    // Finish queued jobs and loads before the resources they may touch go away
+    asw::jobs::shutdown();
+    asw::assets::_shutdown();
+
     asw::input::clear_actions();
 
     // Clear asset caches while SDL resources are still valid — SDL_Destroy*
@@ -1,6 +1,6 @@
 #include "./asw/modules/input.h"
 
-#include <unordered_map>
+#include <algorithm>
 #include <vector>
 
 #include "./asw/modules/action.h"
@@ -9,17 +9,18 @@
 namespace {
 /// @brief Data structure for controller state, including button states and axis values.
 using ControllerState = struct ControllerState {
-    std::array<bool, asw::input::NUM_CONTROLLER_BUTTONS> pressed { false };
-    std::array<bool, asw::input::NUM_CONTROLLER_BUTTONS> released { false };
-    std::array<bool, asw::input::NUM_CONTROLLER_BUTTONS> down { false };
+    asw::input::ControllerButtonSet pressed;
+    asw::input::ControllerButtonSet released;
+    asw::input::ControllerButtonSet down;
 
     bool any_pressed { false };
     int last_pressed { -1 };
-    float dead_zone { 0.25F };
 
     std::array<float, asw::input::NUM_CONTROLLER_AXES> axis { 0 };
 
     SDL_Gamepad* gamepad { nullptr };
+    SDL_JoystickID id { 0 };
+    bool connected { false };
     std::string name;
 };
 
@@ -27,11 +28,192 @@ using ControllerState = struct ControllerState {
 /// the core.
 std::array<SDL_Cursor*, asw::input::NUM_CURSORS> cursors { nullptr };
 
-/// @brief Global controller state.
-std::vector<ControllerState> controller {};
+/// @brief Global controller state, one slot per player. Slots keep their
+/// index while other controllers come and go.
+std::array<ControllerState, asw::input::MAX_CONTROLLERS> controller {};
+
+/// @brief Dead zone of each player index. Kept apart from the slots, which
+/// are reset whenever a controller connects or disconnects, so a dead zone
+/// can be set before its controller is plugged in.
+std::array<float, asw::input::MAX_CONTROLLERS> controller_dead_zones = [] {
+    std::array<float, asw::input::MAX_CONTROLLERS> zones {};
+    zones.fill(0.25F);
+    return zones;
+}();
+
+/// @brief Direct-mapped table from SDL_JoystickID to controller slot. Indexed
+/// by the low bits of the id, probing linearly on collision. Kept at a quarter
+/// full at most, so lookups almost always hit the first entry.
+class ControllerIdTable {
+public:
+    static constexpr size_t SIZE = asw::input::MAX_CONTROLLERS * 4;
+    static constexpr uint8_t EMPTY = 0xFF;
+
+    int find(SDL_JoystickID id) const
+    {
+        for (size_t i = 0; i < SIZE; ++i) {
+            const auto& entry = entries_[(id + i) & MASK];
+            if (entry.slot == EMPTY) {
+                return -1;
+            }
+            if (entry.id == id) {
+                return entry.slot;
+            }
+        }
+        return -1;
+    }
+
+    void insert(SDL_JoystickID id, uint8_t slot)
+    {
+        for (size_t i = 0; i < SIZE; ++i) {
+            auto& entry = entries_[(id + i) & MASK];
+            if (entry.slot == EMPTY || entry.id == id) {
+                entry = { id, slot };
+                return;
+            }
+        }
+    }
+
+    void erase(SDL_JoystickID id)
+    {
+        size_t hole = SIZE;
+        for (size_t i = 0; i < SIZE; ++i) {
+            const auto index = (id + i) & MASK;
+            if (entries_[index].slot == EMPTY) {
+                return;
+            }
+            if (entries_[index].id == id) {
+                hole = index;
+                break;
+            }
+        }
+
+        if (hole == SIZE) {
+            return;
+        }
+
+        // Shift later entries of the probe run back so lookups never stop early
+        auto next = (hole + 1) & MASK;
+        while (entries_[next].slot != EMPTY) {
+            const auto home = entries_[next].id & MASK;
+            if (((next - home) & MASK) >= ((next - hole) & MASK)) {
+                entries_[hole] = entries_[next];
+                hole = next;
+            }
+            next = (next + 1) & MASK;
+        }
+
+        entries_[hole] = {};
+    }
+
+private:
+    static constexpr size_t MASK = SIZE - 1;
+    static_assert((SIZE & MASK) == 0, "Controller id table size must be a power of two");
+
+    struct Entry {
+        SDL_JoystickID id { 0 };
+        uint8_t slot { EMPTY };
+    };
 
-/// @brief Map of SDL_JoystickID to controller index in the controller vector.
-std::unordered_map<SDL_JoystickID, uint32_t> controller_id_map {};
+    std::array<Entry, SIZE> entries_ {};
+};
+
+ControllerIdTable controller_ids;
+
+/// @brief Find the slot of a connected controller.
+///
+/// @param id The SDL joystick id.
+/// @param index Set to the slot index when found.
+/// @return The slot, or nullptr if the id is not connected.
+///
+ControllerState* find_controller(SDL_JoystickID id, uint32_t& index)
+{
+    const auto slot = controller_ids.find(id);
+    if (slot < 0) {
+        return nullptr;
+    }
+
+    index = static_cast<uint32_t>(slot);
+    return &controller[index];
+}
+
+/// @brief Claim the first free slot for a controller.
+///
+/// @param id The SDL joystick id.
+/// @param name The controller name.
+/// @return The claimed controller, or nullptr if every slot is taken.
+///
+ControllerState* claim_controller(SDL_JoystickID id, const std::string& name)
+{
+    for (uint32_t i = 0; i < asw::input::MAX_CONTROLLERS; ++i) {
+        auto& slot = controller[i];
+        if (slot.connected) {
+            continue;
+        }
+
+        slot = {};
+        slot.id = id;
+        slot.connected = true;
+        slot.name = name;
+        controller_ids.insert(id, static_cast<uint8_t>(i));
+        return &slot;
+    }
+
+    return nullptr;
+}
+
+/// @brief Keys whose pressed/released bits were set this tick, so reset only
+/// has to touch those. Falls back to clearing everything on overflow.
+struct DirtyKeys {
+    static constexpr size_t CAPACITY = 32;
+
+    std::array<uint16_t, CAPACITY> keys {};
+    size_t count { 0 };
+    bool overflow { false };
+
+    void mark(SDL_Scancode scancode)
+    {
+        if (count < CAPACITY) {
+            keys[count++] = static_cast<uint16_t>(scancode);
+        } else {
+            overflow = true;
+        }
+    }
+};
+
+DirtyKeys dirty_keys;
+
+/// @brief Ring of raw mouse samples for the current update.
+struct MouseSamples {
+    std::vector<asw::input::MouseSample> ring;
+    size_t head { 0 };
+    size_t count { 0 };
+
+    void push(const asw::input::MouseSample& sample)
+    {
+        if (ring.empty()) {
+            return;
+        }
+
+        ring[(head + count) % ring.size()] = sample;
+        if (count < ring.size()) {
+            ++count;
+        } else {
+            head = (head + 1) % ring.size();
+        }
+    }
+
+    void clear()
+    {
+        head = 0;
+        count = 0;
+    }
+};
+
+MouseSamples mouse_samples;
+
+/// @brief Time of the event being applied by the hooks.
+uint64_t event_time = 0;
 
 asw::input::KeyState keyboard {};
 asw::input::MouseState mouse {};
@@ -70,42 +252,40 @@ void asw::input::reset()
     k_state.any_pressed = false;
     k_state.last_pressed = -1;
 
-    for (auto& pressed : k_state.pressed) {
-        pressed = false;
+    if (dirty_keys.overflow) {
+        k_state.pressed.reset();
+        k_state.released.reset();
+    } else {
+        for (size_t i = 0; i < dirty_keys.count; ++i) {
+            k_state.pressed.reset(dirty_keys.keys[i]);
+            k_state.released.reset(dirty_keys.keys[i]);
+        }
     }
 
-    for (auto& released : k_state.released) {
-        released = false;
-    }
+    dirty_keys.count = 0;
+    dirty_keys.overflow = false;
 
-    // Clear mouse state
+    // Clear mouse state. Button sets fit in one word, so reset them outright.
     m_state.any_pressed = false;
     m_state.change = { 0.0F, 0.0F };
     m_state.z = 0;
-
-    for (auto& pressed : m_state.pressed) {
-        pressed = false;
-    }
-
-    for (auto& released : m_state.released) {
-        released = false;
-    }
+    m_state.pressed.reset();
+    m_state.released.reset();
+    mouse_samples.clear();
 
     // Clear text input
     text_input.clear();
 
     // Clear controller state
     for (auto& cont : controller) {
-        cont.any_pressed = false;
-        cont.last_pressed = -1;
-
-        for (auto& button : cont.pressed) {
-            button = false;
+        if (!cont.connected) {
+            continue;
         }
 
-        for (auto& button : cont.released) {
-            button = false;
-        }
+        cont.any_pressed = false;
+        cont.last_pressed = -1;
+        cont.pressed.reset();
+        cont.released.reset();
     }
 }
 
@@ -127,6 +307,31 @@ bool asw::input::get_mouse_button_up(asw::input::MouseButton button)
     return mouse.released[static_cast<int>(button)];
 }
 
+void asw::input::set_mouse_sample_capacity(size_t capacity)
+{
+    mouse_samples.ring.assign(capacity, {});
+    mouse_samples.clear();
+}
+
+size_t asw::input::get_mouse_sample_capacity()
+{
+    return mouse_samples.ring.size();
+}
+
+size_t asw::input::get_mouse_sample_count()
+{
+    return mouse_samples.count;
+}
+
+asw::input::MouseSample asw::input::get_mouse_sample(size_t index)
+{
+    if (index >= mouse_samples.count) {
+        return {};
+    }
+
+    return mouse_samples.ring[(mouse_samples.head + index) % mouse_samples.ring.size()];
+}
+
 void asw::input::set_cursor(asw::input::CursorId cursor)
 {
     auto cursor_int = static_cast<uint32_t>(cursor);
@@ -160,12 +365,36 @@ bool asw::input::get_key_up(asw::input::Key key)
     return keyboard.released[static_cast<int>(key)];
 }
 
+asw::input::KeySet asw::input::make_key_set(std::initializer_list<asw::input::Key> keys)
+{
+    KeySet set;
+    for (const auto key : keys) {
+        set.set(static_cast<size_t>(key));
+    }
+    return set;
+}
+
+bool asw::input::get_any_key(const KeySet& keys)
+{
+    return (keyboard.down & keys).any();
+}
+
+bool asw::input::get_any_key_down(const KeySet& keys)
+{
+    return (keyboard.pressed & keys).any();
+}
+
+bool asw::input::get_any_key_up(const KeySet& keys)
+{
+    return (keyboard.released & keys).any();
+}
+
 // ---- CONTROLLER ----
 //
 
 bool asw::input::get_controller_button(uint32_t index, asw::input::ControllerButton button)
 {
-    if (index >= controller.size()) {
+    if (index >= asw::input::MAX_CONTROLLERS) {
         return false;
     }
 
@@ -174,7 +403,7 @@ bool asw::input::get_controller_button(uint32_t index, asw::input::ControllerBut
 
 bool asw::input::get_controller_button_down(uint32_t index, asw::input::ControllerButton button)
 {
-    if (index >= controller.size()) {
+    if (index >= asw::input::MAX_CONTROLLERS) {
         return false;
     }
 
@@ -183,7 +412,7 @@ bool asw::input::get_controller_button_down(uint32_t index, asw::input::Controll
 
 bool asw::input::get_controller_button_up(uint32_t index, asw::input::ControllerButton button)
 {
-    if (index >= controller.size()) {
+    if (index >= asw::input::MAX_CONTROLLERS) {
         return false;
     }
 
@@ -192,7 +421,7 @@ bool asw::input::get_controller_button_up(uint32_t index, asw::input::Controller
 
 float asw::input::get_controller_axis(uint32_t index, asw::input::ControllerAxis axis)
 {
-    if (index >= controller.size()) {
+    if (index >= asw::input::MAX_CONTROLLERS) {
         return 0.0F;
     }
 
@@ -201,41 +430,57 @@ float asw::input::get_controller_axis(uint32_t index, asw::input::ControllerAxis
 
 void asw::input::set_controller_dead_zone(uint32_t index, float dead_zone)
 {
-    if (index >= controller.size()) {
+    if (index >= asw::input::MAX_CONTROLLERS) {
         return;
     }
 
-    controller[index].dead_zone = dead_zone;
+    controller_dead_zones[index] = dead_zone;
 }
 
 int asw::input::get_controller_count()
 {
-    return controller.size();
+    return static_cast<int>(std::count_if(controller.begin(), controller.end(),
+        [](const ControllerState& cont) { return cont.connected; }));
+}
+
+bool asw::input::is_controller_connected(uint32_t index)
+{
+    return index < asw::input::MAX_CONTROLLERS && controller[index].connected;
 }
 
 std::string asw::input::get_controller_name(uint32_t index)
 {
-    if (index >= controller.size()) {
+    if (index >= asw::input::MAX_CONTROLLERS) {
         return "";
     }
 
-    return controller.at(index).name;
+    return controller[index].name;
 }
 
 /// Event Hooks
 
+void asw::input::_event_time(uint64_t timestamp)
+{
+    event_time = timestamp;
+}
+
 void asw::input::_key_down(SDL_Scancode scancode)
 {
+    dirty_keys.mark(scancode);
     keyboard.pressed[scancode] = true;
     keyboard.down[scancode] = true;
     keyboard.any_pressed = true;
     keyboard.last_pressed = scancode;
+    keyboard.last_pressed_time = event_time;
+    asw::input::_action_key_changed(scancode);
 }
 
 void asw::input::_key_up(SDL_Scancode scancode)
 {
+    dirty_keys.mark(scancode);
     keyboard.released[scancode] = true;
     keyboard.down[scancode] = false;
+    asw::input::_action_key_changed(scancode);
 }
 
 void asw::input::_mouse_button_down(uint8_t button)
@@ -245,6 +490,8 @@ void asw::input::_mouse_button_down(uint8_t button)
     mouse.down[button_int] = true;
     mouse.any_pressed = true;
     mouse.last_pressed = button_int;
+    mouse.last_pressed_time = event_time;
+    asw::input::_action_mouse_button_changed(button);
 }
 
 void asw::input::_mouse_button_up(uint8_t button)
@@ -252,14 +499,20 @@ void asw::input::_mouse_button_up(uint8_t button)
     const auto button_int = static_cast<int>(button);
     mouse.released[button_int] = true;
     mouse.down[button_int] = false;
+    asw::input::_action_mouse_button_changed(button);
 }
 
 void asw::input::_mouse_motion(float x, float y, float delta_x, float delta_y)
 {
     mouse.position.x = x;
     mouse.position.y = y;
-    mouse.change.x = delta_x;
-    mouse.change.y = delta_y;
+    mouse.change.x += delta_x;
+    mouse.change.y += delta_y;
+}
+
+void asw::input::_mouse_sample(float x, float y, uint64_t timestamp)
+{
+    mouse_samples.push({ .position = { x, y }, .timestamp = timestamp });
 }
 
 void asw::input::_mouse_wheel(float delta_z)
@@ -269,6 +522,10 @@ void asw::input::_mouse_wheel(float delta_z)
 
 void asw::input::_controller_added(SDL_JoystickID id)
 {
+    if (controller_ids.find(id) >= 0) {
+        return;
+    }
+
     if (!SDL_IsGamepad(id)) {
         asw::log::warn("Failed to open gamepad: {}", id);
         return;
@@ -277,80 +534,88 @@ void asw::input::_controller_added(SDL_JoystickID id)
     auto* opened = SDL_OpenGamepad(id);
     if (opened == nullptr) {
         asw::log::warn("Failed to open gamepad: {}", id);
+        return;
+    }
+
+    const char* name = SDL_GetGamepadName(opened);
+    auto* new_controller = claim_controller(id, name != nullptr ? name : "");
+    if (new_controller == nullptr) {
+        asw::log::warn("Too many gamepads, ignoring: {}", id);
+        SDL_CloseGamepad(opened);
+        return;
     }
 
-    // Add controller
-    auto& new_controller = controller.emplace_back();
-    new_controller.gamepad = opened;
-    new_controller.name = SDL_GetGamepadName(opened);
-    controller_id_map[id] = controller.size() - 1;
+    new_controller->gamepad = opened;
+    asw::input::_action_controllers_changed();
 
-    asw::log::info("Gamepad added: {} (ID: {})", new_controller.name, id);
+    asw::log::info("Gamepad added: {} (ID: {})", new_controller->name, id);
 }
 
-void asw::input::_controller_removed(SDL_JoystickID id)
+void asw::input::_virtual_controller_added(SDL_JoystickID id)
 {
-    const auto it = controller_id_map.find(id);
-    if (it == controller_id_map.end()) {
+    if (controller_ids.find(id) >= 0) {
         return;
     }
 
-    // Erase from vector and map
-    const auto index = it->second;
-    controller_id_map.erase(it);
-    controller.erase(controller.begin() + index);
-
-    // Close gamepad if it exists
-    if (auto* existing = SDL_GetGamepadFromID(id); existing != nullptr) {
-        SDL_CloseGamepad(existing);
+    if (claim_controller(id, "Virtual Gamepad") != nullptr) {
+        asw::input::_action_controllers_changed();
     }
 }
 
-void asw::input::_controller_axis_motion(SDL_JoystickID id, uint32_t axis, float value)
+void asw::input::_controller_removed(SDL_JoystickID id)
 {
-    const auto it = controller_id_map.find(id);
-    if (it == controller_id_map.end()) {
+    uint32_t index = 0;
+    auto* cont = find_controller(id, index);
+    if (cont == nullptr) {
         return;
     }
 
-    const auto index = it->second;
-    if (index >= controller.size() || axis >= asw::input::NUM_CONTROLLER_AXES) {
-        return;
+    // Free the slot, other players keep their index
+    if (cont->gamepad != nullptr) {
+        SDL_CloseGamepad(cont->gamepad);
     }
 
-    controller[index].axis[axis] = value / 32768.0F; // Normalize to [-1, 1]
+    *cont = {};
+    controller_ids.erase(id);
+    asw::input::_action_controllers_changed();
 }
 
-void asw::input::_controller_button_down(SDL_JoystickID id, uint32_t button)
+void asw::input::_controller_axis_motion(SDL_JoystickID id, uint32_t axis, float value)
 {
-    const auto it = controller_id_map.find(id);
-    if (it == controller_id_map.end()) {
+    uint32_t index = 0;
+    auto* cont = find_controller(id, index);
+    if (cont == nullptr || axis >= asw::input::NUM_CONTROLLER_AXES) {
         return;
     }
 
-    const auto index = it->second;
-    if (index >= controller.size()) {
+    cont->axis[axis] = value / 32768.0F; // Normalize to [-1, 1]
+    asw::input::_action_controller_axis_changed(index, axis);
+}
+
+void asw::input::_controller_button_down(SDL_JoystickID id, uint32_t button)
+{
+    uint32_t index = 0;
+    auto* cont = find_controller(id, index);
+    if (cont == nullptr || button >= asw::input::NUM_CONTROLLER_BUTTONS) {
         return;
     }
 
-    controller[index].pressed[button] = true;
-    controller[index].down[button] = true;
-    controller[index].any_pressed = true;
-    controller[index].last_pressed = button;
+    cont->pressed[button] = true;
+    cont->down[button] = true;
+    cont->any_pressed = true;
+    cont->last_pressed = static_cast<int>(button);
+    asw::input::_action_controller_button_changed(index, button);
 }
 
 void asw::input::_controller_button_up(SDL_JoystickID id, uint32_t button)
 {
-    const auto it = controller_id_map.find(id);
-    if (it == controller_id_map.end()) {
-        return;
-    }
-
-    const auto index = it->second;
-    if (index >= controller.size()) {
+    uint32_t index = 0;
+    auto* cont = find_controller(id, index);
+    if (cont == nullptr || button >= asw::input::NUM_CONTROLLER_BUTTONS) {
         return;
     }
 
-    controller[index].released[button] = true;
-    controller[index].down[button] = false;
+    cont->released[button] = true;
+    cont->down[button] = false;
+    asw::input::_action_controller_button_changed(index, button);
 }
\ No newline at end of file
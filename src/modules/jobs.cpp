@@ -0,0 +1,621 @@
+#include "./asw/modules/jobs.h"
+
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "./asw/modules/log.h"
+
+namespace asw::jobs {
+
+struct Job {
+    std::function<void()> fn;
+
+    // Chunk of a parallel_for, used instead of fn to skip a std::function
+    const RangeFn* range_fn { nullptr };
+    size_t begin { 0 };
+    size_t end { 0 };
+    size_t grain { 0 };
+
+    Counter* counter { nullptr };
+
+    // Next job in a counter's waiter list or a free list
+    Job* next { nullptr };
+};
+
+/// @brief Scheduler internals, with access to counters.
+///
+struct Scheduler {
+    static void add(Counter& counter, int count);
+    static bool park(Counter& counter, Job* job);
+    static void execute(Job* job);
+    static void split(Job* job);
+    static void worker_main(int index);
+};
+
+namespace {
+    // Jobs a deque holds before spilling into the shared queue
+    constexpr int64_t DEQUE_CAPACITY = 4096;
+
+    // Failed steal attempts before yielding, then before sleeping
+    constexpr int SPIN_ROUNDS = 64;
+    constexpr int YIELD_ROUNDS = 16;
+
+    // Finished jobs each thread keeps for reuse
+    constexpr size_t JOB_CACHE_LIMIT = 1024;
+
+    /// @brief Chase-Lev work stealing deque. The owner pushes and pops at the
+    /// bottom, any thread can steal from the top.
+    ///
+    class WorkDeque {
+    public:
+        bool push(Job* job)
+        {
+            const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+            const int64_t top = top_.load(std::memory_order_acquire);
+
+            if (bottom - top >= DEQUE_CAPACITY) {
+                return false;
+            }
+
+            slots_[bottom & (DEQUE_CAPACITY - 1)].store(job, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        Job* pop()
+        {
+            const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+            bottom_.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t top = top_.load(std::memory_order_relaxed);
+
+            if (top > bottom) {
+                bottom_.store(bottom + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            Job* job = slots_[bottom & (DEQUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+
+            // Last job, race thieves for it
+            if (top == bottom) {
+                if (!top_.compare_exchange_strong(
+                        top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    job = nullptr;
+                }
+                bottom_.store(bottom + 1, std::memory_order_relaxed);
+            }
+
+            return job;
+        }
+
+        Job* steal()
+        {
+            int64_t top = top_.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t bottom = bottom_.load(std::memory_order_acquire);
+
+            if (top >= bottom) {
+                return nullptr;
+            }
+
+            Job* job = slots_[top & (DEQUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+            if (!top_.compare_exchange_strong(
+                    top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return nullptr;
+            }
+
+            return job;
+        }
+
+    private:
+        alignas(64) std::atomic<int64_t> top_ { 0 };
+        alignas(64) std::atomic<int64_t> bottom_ { 0 };
+        std::array<std::atomic<Job*>, DEQUE_CAPACITY> slots_ {};
+    };
+
+    /// @brief Per thread free list of finished jobs.
+    ///
+    struct JobCache {
+        Job* head { nullptr };
+        size_t size { 0 };
+
+        JobCache() = default;
+        JobCache(const JobCache&) = delete;
+        JobCache& operator=(const JobCache&) = delete;
+        JobCache(JobCache&&) = delete;
+        JobCache& operator=(JobCache&&) = delete;
+
+        ~JobCache();
+    };
+
+    thread_local int thread_index = -1;
+    thread_local uint32_t steal_seed = 0;
+    thread_local JobCache job_cache;
+
+    // Set once this thread's cache is destroyed. Static destruction, such as
+    // the shutdown guard, runs after it on the main thread. Trivially
+    // destructible, so it stays readable.
+    thread_local bool job_cache_destroyed = false;
+
+    JobCache::~JobCache()
+    {
+        job_cache_destroyed = true;
+
+        while (head != nullptr) {
+            Job* next = head->next;
+            delete head;
+            head = next;
+        }
+    }
+
+    // Deque per thread, index 0 belongs to the thread that started the pool
+    std::vector<std::unique_ptr<WorkDeque>> deques;
+    std::vector<std::thread> workers;
+
+    // Jobs from threads without a deque, or from full deques
+    std::mutex shared_lock;
+    std::deque<Job*> shared_queue;
+    std::atomic<size_t> shared_size { 0 };
+
+    // Jobs queued and not yet taken, so sleeping workers know to wake
+    std::atomic<int64_t> queued { 0 };
+    std::atomic<int> sleeping { 0 };
+    std::mutex sleep_lock;
+    std::condition_variable sleep_signal;
+
+    std::atomic<bool> running { false };
+    std::atomic<bool> stopping { false };
+    std::mutex start_lock;
+
+    Job* allocate_job()
+    {
+        if (job_cache_destroyed || job_cache.head == nullptr) {
+            return new Job();
+        }
+
+        Job* job = job_cache.head;
+        job_cache.head = job->next;
+        job_cache.size--;
+        job->next = nullptr;
+        return job;
+    }
+
+    void free_job(Job* job)
+    {
+        if (job_cache_destroyed || job_cache.size >= JOB_CACHE_LIMIT) {
+            delete job;
+            return;
+        }
+
+        job->fn = nullptr;
+        job->range_fn = nullptr;
+        job->counter = nullptr;
+        job->next = job_cache.head;
+        job_cache.head = job;
+        job_cache.size++;
+    }
+
+    uint32_t next_victim()
+    {
+        // xorshift32, seeded per thread
+        if (steal_seed == 0) {
+            steal_seed = static_cast<uint32_t>(thread_index + 2) * 2654435761U;
+        }
+
+        steal_seed ^= steal_seed << 13;
+        steal_seed ^= steal_seed >> 17;
+        steal_seed ^= steal_seed << 5;
+        return steal_seed;
+    }
+
+    void wake_worker()
+    {
+        if (sleeping.load() > 0) {
+            const std::lock_guard lock(sleep_lock);
+            sleep_signal.notify_one();
+        }
+    }
+
+    void push(Job* job)
+    {
+        queued.fetch_add(1);
+
+        if (thread_index < 0 || !deques[thread_index]->push(job)) {
+            const std::lock_guard lock(shared_lock);
+            shared_queue.push_back(job);
+            shared_size.fetch_add(1, std::memory_order_release);
+        }
+
+        wake_worker();
+    }
+
+    Job* take()
+    {
+        Job* job = nullptr;
+
+        if (thread_index >= 0) {
+            job = deques[thread_index]->pop();
+        }
+
+        if (job == nullptr && shared_size.load(std::memory_order_acquire) > 0) {
+            const std::lock_guard lock(shared_lock);
+            if (!shared_queue.empty()) {
+                job = shared_queue.front();
+                shared_queue.pop_front();
+                shared_size.fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+        if (job == nullptr && !deques.empty()) {
+            const auto count = static_cast<uint32_t>(deques.size());
+            const uint32_t start = next_victim() % count;
+
+            for (uint32_t i = 0; i < count && job == nullptr; ++i) {
+                const uint32_t victim = (start + i) % count;
+                if (static_cast<int>(victim) != thread_index) {
+                    job = deques[victim]->steal();
+                }
+            }
+        }
+
+        if (job != nullptr) {
+            queued.fetch_sub(1);
+        }
+
+        return job;
+    }
+
+    void start(size_t worker_count)
+    {
+        const std::lock_guard lock(start_lock);
+
+        if (running.load()) {
+            return;
+        }
+
+        if (worker_count == 0) {
+            const size_t hardware = std::thread::hardware_concurrency();
+            worker_count = std::max<size_t>(hardware, 2) - 1;
+        }
+
+        stopping = false;
+        thread_index = 0;
+
+        deques.clear();
+        for (size_t i = 0; i < worker_count + 1; ++i) {
+            deques.push_back(std::make_unique<WorkDeque>());
+        }
+
+        workers.reserve(worker_count);
+        for (size_t i = 0; i < worker_count; ++i) {
+            workers.emplace_back(
+                [index = static_cast<int>(i + 1)] { Scheduler::worker_main(index); });
+        }
+
+        running.store(true, std::memory_order_release);
+    }
+
+    void ensure_started()
+    {
+        if (!running.load(std::memory_order_acquire)) {
+            start(0);
+        }
+    }
+} // namespace
+
+void Scheduler::add(Counter& counter, int count)
+{
+    counter.pending_.fetch_add(count, std::memory_order_relaxed);
+}
+
+bool Scheduler::park(Counter& counter, Job* job)
+{
+    counter.lock();
+    const bool parked = counter.pending_.load(std::memory_order_acquire) != 0;
+    if (parked) {
+        job->next = counter.waiters_;
+        counter.waiters_ = job;
+    }
+    counter.unlock();
+
+    return parked;
+}
+
+void Scheduler::split(Job* job)
+{
+    const RangeFn& fn = *job->range_fn;
+    const size_t begin = job->begin;
+    size_t end = job->end;
+
+    // Hand off the upper half until the chunk is small enough, thieves take
+    // the oldest and largest halves first
+    while (end - begin > job->grain) {
+        const size_t mid = begin + ((end - begin) / 2);
+
+        Job* half = allocate_job();
+        half->range_fn = job->range_fn;
+        half->begin = mid;
+        half->end = end;
+        half->grain = job->grain;
+        half->counter = job->counter;
+        add(*job->counter, 1);
+        push(half);
+
+        end = mid;
+    }
+
+    fn(begin, end);
+}
+
+void Scheduler::execute(Job* job)
+{
+    if (job->range_fn != nullptr) {
+        split(job);
+    } else {
+        job->fn();
+    }
+
+    Counter* counter = job->counter;
+    free_job(job);
+
+    if (counter == nullptr) {
+        return;
+    }
+
+    // Final decrement happens under the lock, so once a waiter sees zero and
+    // the lock free, nothing here touches the counter again
+    Job* ready = nullptr;
+    counter->lock();
+    if (counter->pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        ready = counter->waiters_;
+        counter->waiters_ = nullptr;
+    }
+    counter->unlock();
+
+    while (ready != nullptr) {
+        Job* next = ready->next;
+        ready->next = nullptr;
+        push(ready);
+        ready = next;
+    }
+}
+
+void Scheduler::worker_main(int index)
+{
+    thread_index = index;
+
+    int idle = 0;
+
+    while (true) {
+        if (Job* job = take()) {
+            execute(job);
+            idle = 0;
+            continue;
+        }
+
+        if (stopping.load()) {
+            break;
+        }
+
+        idle++;
+        if (idle < SPIN_ROUNDS) {
+            SDL_CPUPauseInstruction();
+        } else if (idle < SPIN_ROUNDS + YIELD_ROUNDS) {
+            std::this_thread::yield();
+        } else {
+            std::unique_lock lock(sleep_lock);
+            sleeping.fetch_add(1);
+            sleep_signal.wait(lock, [] { return stopping.load() || queued.load() > 0; });
+            sleeping.fetch_sub(1);
+            idle = 0;
+        }
+    }
+
+    thread_index = -1;
+}
+
+bool Counter::is_done() const
+{
+    if (pending_.load(std::memory_order_acquire) != 0) {
+        return false;
+    }
+
+    // Let the job that made the final decrement leave the lock
+    while (locked_.load(std::memory_order_acquire)) {
+        SDL_CPUPauseInstruction();
+    }
+
+    return true;
+}
+
+int Counter::get_pending() const
+{
+    return pending_.load(std::memory_order_acquire);
+}
+
+void Counter::lock() const
+{
+    while (locked_.exchange(true, std::memory_order_acquire)) {
+        while (locked_.load(std::memory_order_relaxed)) {
+            SDL_CPUPauseInstruction();
+        }
+    }
+}
+
+void Counter::unlock() const
+{
+    locked_.store(false, std::memory_order_release);
+}
+
+void init(size_t worker_count)
+{
+    if (running.load()) {
+        asw::log::warn("Job system already running with {} workers", workers.size());
+        return;
+    }
+
+    start(worker_count);
+    asw::log::info("Job system started with {} workers", workers.size());
+}
+
+void shutdown()
+{
+    const std::lock_guard lock(start_lock);
+
+    if (!running.load()) {
+        return;
+    }
+
+    // Workers drain every queued job before exiting
+    {
+        const std::lock_guard sleep_guard(sleep_lock);
+        stopping = true;
+    }
+    sleep_signal.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // Anything pushed by the last jobs after the workers left
+    while (Job* job = take()) {
+        Scheduler::execute(job);
+    }
+
+    workers.clear();
+    deques.clear();
+    running.store(false, std::memory_order_release);
+    thread_index = -1;
+}
+
+size_t get_worker_count()
+{
+    return workers.size();
+}
+
+bool is_worker_thread()
+{
+    return thread_index > 0;
+}
+
+int get_thread_index()
+{
+    return thread_index;
+}
+
+void run(std::function<void()> fn, Counter* counter)
+{
+    ensure_started();
+
+    Job* job = allocate_job();
+    job->fn = std::move(fn);
+    job->counter = counter;
+
+    if (counter != nullptr) {
+        Scheduler::add(*counter, 1);
+    }
+
+    push(job);
+}
+
+void run_after(Counter& dependency, std::function<void()> fn, Counter* counter)
+{
+    ensure_started();
+
+    Job* job = allocate_job();
+    job->fn = std::move(fn);
+    job->counter = counter;
+
+    if (counter != nullptr) {
+        Scheduler::add(*counter, 1);
+    }
+
+    // Park on the dependency, unless it already finished
+    if (!Scheduler::park(dependency, job)) {
+        push(job);
+    }
+}
+
+void parallel_for(size_t begin, size_t end, size_t grain, const RangeFn& fn)
+{
+    if (begin >= end) {
+        return;
+    }
+
+    ensure_started();
+
+    if (grain == 0) {
+        const size_t chunks = (workers.size() + 1) * 4;
+        grain = std::max<size_t>((end - begin) / chunks, 1);
+    }
+
+    if (end - begin <= grain) {
+        fn(begin, end);
+        return;
+    }
+
+    Counter counter;
+    Scheduler::add(counter, 1);
+
+    // Split on the calling thread, the first chunk runs here
+    Job* job = allocate_job();
+    job->range_fn = &fn;
+    job->begin = begin;
+    job->end = end;
+    job->grain = grain;
+    job->counter = &counter;
+    Scheduler::execute(job);
+
+    wait(counter);
+}
+
+void wait(const Counter& counter)
+{
+    int idle = 0;
+
+    while (!counter.is_done()) {
+        if (Job* job = take()) {
+            Scheduler::execute(job);
+            idle = 0;
+            continue;
+        }
+
+        idle++;
+        if (idle < SPIN_ROUNDS) {
+            SDL_CPUPauseInstruction();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+namespace {
+    /// @brief Stops the pool at exit for programs that never call shutdown(),
+    /// joinable threads would otherwise terminate the program.
+    ///
+    struct ShutdownGuard {
+        ShutdownGuard() = default;
+        ShutdownGuard(const ShutdownGuard&) = delete;
+        ShutdownGuard& operator=(const ShutdownGuard&) = delete;
+        ShutdownGuard(ShutdownGuard&&) = delete;
+        ShutdownGuard& operator=(ShutdownGuard&&) = delete;
+
+        ~ShutdownGuard()
+        {
+            shutdown();
+        }
+    };
+
+    ShutdownGuard shutdown_guard;
+} // namespace
+
+} // namespace asw::jobs
@@ -0,0 +1,302 @@
+#include "./asw/modules/physics.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+/// @brief Longest ray walk, in cells, so an unbounded ray still terminates.
+constexpr int MAX_RAY_CELLS = 1 << 16;
+
+/// @brief Slab test of a ray against a box.
+///
+/// @return Distance to the entry point, or a negative value on a miss.
+///
+float ray_box(const asw::Vec2<float>& origin, const asw::Vec2<float>& dir,
+    const asw::Quad<float>& box, float max_distance)
+{
+    float t_near = 0.0F;
+    float t_far = max_distance;
+
+    const float origins[2] = { origin.x, origin.y };
+    const float dirs[2] = { dir.x, dir.y };
+    const float mins[2] = { box.position.x, box.position.y };
+    const float maxs[2] = { box.position.x + box.size.x, box.position.y + box.size.y };
+
+    for (int axis = 0; axis < 2; ++axis) {
+        if (dirs[axis] == 0.0F) {
+            if (origins[axis] < mins[axis] || origins[axis] > maxs[axis]) {
+                return -1.0F;
+            }
+            continue;
+        }
+
+        const float inv = 1.0F / dirs[axis];
+        float t0 = (mins[axis] - origins[axis]) * inv;
+        float t1 = (maxs[axis] - origins[axis]) * inv;
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+
+        t_near = std::max(t_near, t0);
+        t_far = std::min(t_far, t1);
+        if (t_near > t_far) {
+            return -1.0F;
+        }
+    }
+
+    return t_near;
+}
+
+} // namespace
+
+asw::physics::SpatialHash::SpatialHash(float cell_size)
+{
+    set_cell_size(cell_size);
+}
+
+void asw::physics::SpatialHash::set_cell_size(float cell_size)
+{
+    cell_size_ = std::max(cell_size, 1.0F);
+    inv_cell_size_ = 1.0F / cell_size_;
+}
+
+float asw::physics::SpatialHash::get_cell_size() const
+{
+    return cell_size_;
+}
+
+size_t asw::physics::SpatialHash::size() const
+{
+    return entries_.size();
+}
+
+asw::physics::SpatialHash::CellRange asw::physics::SpatialHash::cells_of(
+    const Quad<float>& rect) const
+{
+    return { static_cast<int>(std::floor(rect.position.x * inv_cell_size_)),
+        static_cast<int>(std::floor(rect.position.y * inv_cell_size_)),
+        static_cast<int>(std::floor((rect.position.x + rect.size.x) * inv_cell_size_)),
+        static_cast<int>(std::floor((rect.position.y + rect.size.y) * inv_cell_size_)) };
+}
+
+uint32_t asw::physics::SpatialHash::bucket_of(int x, int y) const
+{
+    const auto hash
+        = (static_cast<uint32_t>(x) * 73856093U) ^ (static_cast<uint32_t>(y) * 19349663U);
+    return hash & bucket_mask_;
+}
+
+void asw::physics::SpatialHash::rebuild(
+    const std::vector<std::shared_ptr<game::GameObject>>& objects)
+{
+    entries_.clear();
+    for (const auto& obj : objects) {
+        if (obj->active && obj->alive) {
+            entries_.push_back({ obj.get(), obj->transform, obj->collision_layer,
+                obj->collision_mask, cells_of(obj->transform) });
+        }
+    }
+
+    // Count covered cells first to size the table, about one bucket per cell
+    size_t cell_count = 0;
+    for (const auto& entry : entries_) {
+        const auto& range = entry.cells;
+        cell_count += static_cast<size_t>(range.x1 - range.x0 + 1)
+            * static_cast<size_t>(range.y1 - range.y0 + 1);
+    }
+
+    const auto bucket_count = std::bit_ceil(std::max<size_t>(cell_count, 16));
+    bucket_mask_ = static_cast<uint32_t>(bucket_count - 1);
+
+    refs_.clear();
+    refs_.reserve(cell_count);
+
+    for (uint32_t i = 0; i < entries_.size(); ++i) {
+        const auto& range = entries_[i].cells;
+        for (int y = range.y0; y <= range.y1; ++y) {
+            for (int x = range.x0; x <= range.x1; ++x) {
+                refs_.emplace_back(bucket_of(x, y), i);
+            }
+        }
+    }
+
+    // Counting sort refs into contiguous per-bucket runs
+    bucket_start_.assign(bucket_count + 1, 0);
+    for (const auto& [bucket, entry] : refs_) {
+        bucket_start_[bucket + 1]++;
+    }
+
+    for (size_t b = 0; b < bucket_count; ++b) {
+        bucket_start_[b + 1] += bucket_start_[b];
+    }
+
+    bucket_entries_.resize(refs_.size());
+    for (const auto& [bucket, entry] : refs_) {
+        // Fill each run from the back, using the next run's start as a cursor
+        bucket_entries_[--bucket_start_[bucket + 1]] = entry;
+    }
+
+    // Runs were filled backwards, which shifted each start down by one run
+    std::rotate(bucket_start_.begin(), bucket_start_.begin() + 1, bucket_start_.end());
+    bucket_start_.back() = static_cast<uint32_t>(refs_.size());
+}
+
+template <typename Fn>
+void asw::physics::SpatialHash::visit(const CellRange& range, Fn&& fn) const
+{
+    const auto width = static_cast<size_t>(range.x1 - range.x0 + 1);
+    const auto height = static_cast<size_t>(range.y1 - range.y0 + 1);
+
+    // Large areas are cheaper to answer by scanning every entry
+    if (width * height > entries_.size()) {
+        for (uint32_t i = 0; i < entries_.size(); ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    for (int y = range.y0; y <= range.y1; ++y) {
+        for (int x = range.x0; x <= range.x1; ++x) {
+            const auto bucket = bucket_of(x, y);
+            const auto start = bucket_start_[bucket];
+            for (auto k = start; k < bucket_start_[bucket + 1]; ++k) {
+                const auto index = bucket_entries_[k];
+
+                // An entry covering several cells of one bucket is listed that
+                // many times in a row
+                if (k > start && bucket_entries_[k - 1] == index) {
+                    continue;
+                }
+
+                // Report an entry only from the first cell it shares with the
+                // range, and skip entries of other cells in the same bucket.
+                // Nothing is written, so queries can run in parallel.
+                const auto& cells = entries_[index].cells;
+                if (x == std::max(cells.x0, range.x0) && y == std::max(cells.y0, range.y0)
+                    && x <= cells.x1 && y <= cells.y1) {
+                    fn(index);
+                }
+            }
+        }
+    }
+}
+
+void asw::physics::SpatialHash::query_rect(
+    const Quad<float>& rect, std::vector<game::GameObject*>& out, uint32_t mask) const
+{
+    out.clear();
+    if (entries_.empty()) {
+        return;
+    }
+
+    visit(cells_of(rect), [&](uint32_t index) {
+        const auto& entry = entries_[index];
+        if ((entry.layer & mask) != 0 && entry.bounds.collides(rect)) {
+            out.push_back(entry.object);
+        }
+    });
+}
+
+void asw::physics::SpatialHash::query_point(
+    const Vec2<float>& point, std::vector<game::GameObject*>& out, uint32_t mask) const
+{
+    out.clear();
+    if (entries_.empty()) {
+        return;
+    }
+
+    visit(cells_of(Quad<float>(point, { 0.0F, 0.0F })), [&](uint32_t index) {
+        const auto& entry = entries_[index];
+        if ((entry.layer & mask) != 0 && entry.bounds.contains(point)) {
+            out.push_back(entry.object);
+        }
+    });
+}
+
+std::optional<asw::physics::RayHit> asw::physics::SpatialHash::raycast(
+    const Vec2<float>& origin, const Vec2<float>& direction, float max_distance,
+    uint32_t mask) const
+{
+    const float length = direction.magnitude();
+    if (entries_.empty() || length == 0.0F || max_distance <= 0.0F) {
+        return std::nullopt;
+    }
+
+    const Vec2<float> dir(direction.x / length, direction.y / length);
+
+    // Walk the grid cell by cell (Amanatides & Woo)
+    int x = static_cast<int>(std::floor(origin.x * inv_cell_size_));
+    int y = static_cast<int>(std::floor(origin.y * inv_cell_size_));
+
+    const int step_x = dir.x > 0.0F ? 1 : -1;
+    const int step_y = dir.y > 0.0F ? 1 : -1;
+
+    constexpr float inf = std::numeric_limits<float>::infinity();
+
+    const float next_x = static_cast<float>(x + (step_x > 0 ? 1 : 0)) * cell_size_;
+    const float next_y = static_cast<float>(y + (step_y > 0 ? 1 : 0)) * cell_size_;
+
+    float t_max_x = dir.x != 0.0F ? (next_x - origin.x) / dir.x : inf;
+    float t_max_y = dir.y != 0.0F ? (next_y - origin.y) / dir.y : inf;
+
+    const float t_delta_x = dir.x != 0.0F ? cell_size_ / std::abs(dir.x) : inf;
+    const float t_delta_y = dir.y != 0.0F ? cell_size_ / std::abs(dir.y) : inf;
+
+    std::optional<RayHit> best;
+    float best_distance = max_distance;
+    float t = 0.0F;
+
+    for (int steps = 0; steps < MAX_RAY_CELLS && t <= best_distance; ++steps) {
+        const auto bucket = bucket_of(x, y);
+        for (auto k = bucket_start_[bucket]; k < bucket_start_[bucket + 1]; ++k) {
+            // Entries spanning several cells are tested again in each, which
+            // finds the same distance and leaves the nearest hit unchanged
+            const auto& entry = entries_[bucket_entries_[k]];
+            if ((entry.layer & mask) == 0) {
+                continue;
+            }
+
+            const float hit = ray_box(origin, dir, entry.bounds, best_distance);
+            if (hit >= 0.0F && (!best || hit < best_distance)) {
+                best_distance = hit;
+                best = RayHit { entry.object, hit,
+                    Vec2<float>(origin.x + dir.x * hit, origin.y + dir.y * hit) };
+            }
+        }
+
+        if (t_max_x < t_max_y) {
+            t = t_max_x;
+            t_max_x += t_delta_x;
+            x += step_x;
+        } else {
+            t = t_max_y;
+            t_max_y += t_delta_y;
+            y += step_y;
+        }
+    }
+
+    return best;
+}
+
+void asw::physics::SpatialHash::for_each_pair(
+    const std::function<void(game::GameObject&, game::GameObject&)>& fn) const
+{
+    for (uint32_t i = 0; i < entries_.size(); ++i) {
+        const auto& a = entries_[i];
+
+        visit(a.cells, [&](uint32_t j) {
+            // Report each pair from its lower index only
+            if (j <= i) {
+                return;
+            }
+
+            const auto& b = entries_[j];
+            if ((a.layer & b.mask) != 0 && (b.layer & a.mask) != 0 && a.bounds.collides(b.bounds)) {
+                fn(*a.object, *b.object);
+            }
+        });
+    }
+}
@@ -1,47 +1,140 @@
 #include "./asw/modules/random.h"
 
+#include <bit>
 #include <random>
 
 namespace asw::random {
 namespace {
-    // Random number generator
-    std::random_device rd;
-    std::mt19937 rng(rd());
+    /// @brief Step a splitmix64 generator, used to expand seeds.
+    uint64_t splitmix(uint64_t& x)
+    {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    /// @brief Seed for the default stream, from the system.
+    uint64_t system_seed()
+    {
+        std::random_device rd;
+        return (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+
+    // Default stream for the free functions
+    Stream rng(system_seed());
 } // namespace
 
+Stream::Stream(uint64_t seed)
+{
+    this->seed(seed);
+}
+
+void Stream::seed(uint64_t seed)
+{
+    for (auto& word : state_) {
+        word = splitmix(seed);
+    }
+}
+
+uint64_t Stream::next()
+{
+    // xoshiro256**
+    const uint64_t result = std::rotl(state_[1] * 5, 7) * 9;
+    const uint64_t t = state_[1] << 17;
+
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = std::rotl(state_[3], 45);
+
+    return result;
+}
+
+int Stream::between(int min, int max)
+{
+    if (max <= min) {
+        return min;
+    }
+
+    // Lemire's multiply and reject, unbiased over the 2^32 range
+    const uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(max) - min) + 1;
+    uint64_t product = (next() >> 32) * range;
+    auto low = static_cast<uint32_t>(product);
+
+    if (low < range) {
+        const auto threshold = static_cast<uint32_t>((0x100000000ULL - range) % range);
+        while (low < threshold) {
+            product = (next() >> 32) * range;
+            low = static_cast<uint32_t>(product);
+        }
+    }
+
+    return static_cast<int>(min + static_cast<int64_t>(product >> 32));
+}
+
+float Stream::between(float min, float max)
+{
+    // 24 random mantissa bits give a float in [0, 1)
+    const float unit = static_cast<float>(next() >> 40) * 0x1.0p-24F;
+    const float value = min + (unit * (max - min));
+    return value < max ? value : min;
+}
+
+bool Stream::chance(float chance)
+{
+    return between(0.0F, 1.0F) < chance;
+}
+
+State Stream::get_state() const
+{
+    return state_;
+}
+
+void Stream::set_state(const State& state)
+{
+    state_ = state;
+}
+
+void seed(uint64_t seed)
+{
+    rng.seed(seed);
+}
+
+Stream& get_stream()
+{
+    return rng;
+}
+
 int random(int max)
 {
-    std::uniform_int_distribution dist(0, max);
-    return dist(rng);
+    return rng.between(0, max);
 }
 
 int between(int min, int max)
 {
-    std::uniform_int_distribution dist(min, max);
-    return dist(rng);
+    return rng.between(min, max);
 }
 
 float random(float max)
 {
-    std::uniform_real_distribution dist(0.0F, max);
-    return dist(rng);
+    return rng.between(0.0F, max);
 }
 
 float between(float min, float max)
 {
-    std::uniform_real_distribution dist(min, max);
-    return dist(rng);
+    return rng.between(min, max);
 }
 
 bool chance()
 {
-    std::uniform_int_distribution dist(0, 1);
-    return dist(rng) == 1;
+    return (rng.next() >> 63) == 1;
 }
 
 bool chance(float chance)
 {
-    std::uniform_real_distribution dist(0.0F, 1.0F);
-    return dist(rng) < chance;
+    return rng.chance(chance);
 }
 } // namespace asw::random
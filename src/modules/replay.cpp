@@ -0,0 +1,427 @@
+#include "./asw/modules/replay.h"
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "./asw/modules/input.h"
+#include "./asw/modules/log.h"
+
+namespace {
+using asw::input::InputEvent;
+
+/// @brief Stream header: magic followed by a format version.
+constexpr std::array<uint8_t, 4> MAGIC { 'A', 'S', 'W', 'R' };
+constexpr uint8_t VERSION = 2;
+constexpr size_t HEADER_SIZE = MAGIC.size() + 1;
+
+/// @brief Marks the end of a tick in the stream.
+constexpr uint8_t END_OF_TICK = 0xFF;
+
+bool recording = false;
+std::vector<uint8_t> record_buffer;
+
+bool replaying = false;
+std::vector<uint8_t> replay_buffer;
+size_t replay_cursor = 0;
+
+// ---------------------------------------------------------------------------
+// Encoding
+// ---------------------------------------------------------------------------
+
+void write_u8(uint8_t value)
+{
+    record_buffer.push_back(value);
+}
+
+void write_u16(uint16_t value)
+{
+    write_u8(static_cast<uint8_t>(value & 0xFF));
+    write_u8(static_cast<uint8_t>(value >> 8));
+}
+
+void write_u32(uint32_t value)
+{
+    write_u16(static_cast<uint16_t>(value & 0xFFFF));
+    write_u16(static_cast<uint16_t>(value >> 16));
+}
+
+void write_u64(uint64_t value)
+{
+    write_u32(static_cast<uint32_t>(value & 0xFFFFFFFF));
+    write_u32(static_cast<uint32_t>(value >> 32));
+}
+
+void write_f32(float value)
+{
+    write_u32(std::bit_cast<uint32_t>(value));
+}
+
+void write_event(const InputEvent& event)
+{
+    write_u8(static_cast<uint8_t>(event.type));
+    write_u64(event.timestamp);
+
+    switch (event.type) {
+    case InputEvent::Type::KeyDown:
+    case InputEvent::Type::KeyUp:
+        write_u16(static_cast<uint16_t>(event.code));
+        break;
+
+    case InputEvent::Type::MouseButtonDown:
+    case InputEvent::Type::MouseButtonUp:
+        write_u8(static_cast<uint8_t>(event.code));
+        break;
+
+    case InputEvent::Type::MouseMotion:
+        write_f32(event.x);
+        write_f32(event.y);
+        write_f32(event.delta_x);
+        write_f32(event.delta_y);
+        break;
+
+    case InputEvent::Type::MouseWheel:
+        write_f32(event.y);
+        break;
+
+    case InputEvent::Type::ControllerAdded:
+    case InputEvent::Type::ControllerRemoved:
+        write_u32(event.code);
+        break;
+
+    case InputEvent::Type::ControllerAxisMotion:
+        write_u32(event.code);
+        write_u8(static_cast<uint8_t>(event.index));
+        write_f32(event.x);
+        break;
+
+    case InputEvent::Type::ControllerButtonDown:
+    case InputEvent::Type::ControllerButtonUp:
+        write_u32(event.code);
+        write_u8(static_cast<uint8_t>(event.index));
+        break;
+
+    case InputEvent::Type::Text:
+        write_u16(static_cast<uint16_t>(event.text.size()));
+        record_buffer.insert(record_buffer.end(), event.text.begin(), event.text.end());
+        break;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Decoding
+// ---------------------------------------------------------------------------
+
+/// @brief Sequential reader over the replay buffer. Reads past the end fail
+/// the reader instead of touching memory.
+class Reader {
+public:
+    bool ok() const
+    {
+        return ok_;
+    }
+
+    uint8_t u8()
+    {
+        if (replay_cursor + 1 > replay_buffer.size()) {
+            ok_ = false;
+            return 0;
+        }
+        return replay_buffer[replay_cursor++];
+    }
+
+    uint16_t u16()
+    {
+        const auto lo = u8();
+        const auto hi = u8();
+        return static_cast<uint16_t>(lo | (hi << 8));
+    }
+
+    uint32_t u32()
+    {
+        const auto lo = u16();
+        const auto hi = u16();
+        return lo | (static_cast<uint32_t>(hi) << 16);
+    }
+
+    uint64_t u64()
+    {
+        const auto lo = u32();
+        const auto hi = u32();
+        return lo | (static_cast<uint64_t>(hi) << 32);
+    }
+
+    float f32()
+    {
+        return std::bit_cast<float>(u32());
+    }
+
+    std::string text(size_t size)
+    {
+        if (replay_cursor + size > replay_buffer.size()) {
+            ok_ = false;
+            return {};
+        }
+
+        std::string result(
+            replay_buffer.begin() + replay_cursor, replay_buffer.begin() + replay_cursor + size);
+        replay_cursor += size;
+        return result;
+    }
+
+private:
+    bool ok_ { true };
+};
+
+bool read_event(Reader& reader, uint8_t type, InputEvent& event)
+{
+    event.type = static_cast<InputEvent::Type>(type);
+    event.timestamp = reader.u64();
+
+    switch (event.type) {
+    case InputEvent::Type::KeyDown:
+    case InputEvent::Type::KeyUp:
+        event.code = reader.u16();
+        break;
+
+    case InputEvent::Type::MouseButtonDown:
+    case InputEvent::Type::MouseButtonUp:
+        event.code = reader.u8();
+        break;
+
+    case InputEvent::Type::MouseMotion:
+        event.x = reader.f32();
+        event.y = reader.f32();
+        event.delta_x = reader.f32();
+        event.delta_y = reader.f32();
+        break;
+
+    case InputEvent::Type::MouseWheel:
+        event.y = reader.f32();
+        break;
+
+    case InputEvent::Type::ControllerAdded:
+    case InputEvent::Type::ControllerRemoved:
+        event.code = reader.u32();
+        break;
+
+    case InputEvent::Type::ControllerAxisMotion:
+        event.code = reader.u32();
+        event.index = reader.u8();
+        event.x = reader.f32();
+        break;
+
+    case InputEvent::Type::ControllerButtonDown:
+    case InputEvent::Type::ControllerButtonUp:
+        event.code = reader.u32();
+        event.index = reader.u8();
+        break;
+
+    case InputEvent::Type::Text:
+        event.text = reader.text(reader.u16());
+        break;
+
+    default:
+        return false;
+    }
+
+    return reader.ok();
+}
+
+// ---------------------------------------------------------------------------
+// Dispatch
+// ---------------------------------------------------------------------------
+
+void apply(const InputEvent& event)
+{
+    asw::input::_event_time(event.timestamp);
+
+    switch (event.type) {
+    case InputEvent::Type::KeyDown:
+        asw::input::_key_down(static_cast<SDL_Scancode>(event.code));
+        break;
+
+    case InputEvent::Type::KeyUp:
+        asw::input::_key_up(static_cast<SDL_Scancode>(event.code));
+        break;
+
+    case InputEvent::Type::MouseButtonDown:
+        asw::input::_mouse_button_down(static_cast<uint8_t>(event.code));
+        break;
+
+    case InputEvent::Type::MouseButtonUp:
+        asw::input::_mouse_button_up(static_cast<uint8_t>(event.code));
+        break;
+
+    case InputEvent::Type::MouseMotion:
+        asw::input::_mouse_motion(event.x, event.y, event.delta_x, event.delta_y);
+        break;
+
+    case InputEvent::Type::MouseWheel:
+        asw::input::_mouse_wheel(event.y);
+        break;
+
+    case InputEvent::Type::ControllerAdded:
+        if (replaying) {
+            // The recorded device is not plugged in, stand in for it
+            asw::input::_virtual_controller_added(event.code);
+        } else {
+            asw::input::_controller_added(event.code);
+        }
+        break;
+
+    case InputEvent::Type::ControllerRemoved:
+        asw::input::_controller_removed(event.code);
+        break;
+
+    case InputEvent::Type::ControllerAxisMotion:
+        asw::input::_controller_axis_motion(event.code, event.index, event.x);
+        break;
+
+    case InputEvent::Type::ControllerButtonDown:
+        asw::input::_controller_button_down(event.code, event.index);
+        break;
+
+    case InputEvent::Type::ControllerButtonUp:
+        asw::input::_controller_button_up(event.code, event.index);
+        break;
+
+    case InputEvent::Type::Text:
+        asw::input::_append_text(event.text.c_str());
+        break;
+    }
+}
+
+} // namespace
+
+void asw::input::start_recording()
+{
+    record_buffer.clear();
+    record_buffer.insert(record_buffer.end(), MAGIC.begin(), MAGIC.end());
+    record_buffer.push_back(VERSION);
+    recording = true;
+}
+
+std::vector<uint8_t> asw::input::stop_recording()
+{
+    recording = false;
+    return std::move(record_buffer);
+}
+
+bool asw::input::is_recording()
+{
+    return recording;
+}
+
+bool asw::input::start_replay(std::vector<uint8_t> data)
+{
+    if (data.size() < HEADER_SIZE || !std::equal(MAGIC.begin(), MAGIC.end(), data.begin())) {
+        asw::log::error("Invalid input recording");
+        return false;
+    }
+
+    if (data[MAGIC.size()] != VERSION) {
+        asw::log::error("Unsupported input recording version: {}", data[MAGIC.size()]);
+        return false;
+    }
+
+    replay_buffer = std::move(data);
+    replay_cursor = HEADER_SIZE;
+    replaying = true;
+    return true;
+}
+
+void asw::input::stop_replay()
+{
+    replaying = false;
+    replay_buffer.clear();
+    replay_cursor = 0;
+}
+
+bool asw::input::is_replaying()
+{
+    return replaying;
+}
+
+bool asw::input::save_recording(const std::string& path, const std::vector<uint8_t>& data)
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        asw::log::error("Failed to open {} for writing", path);
+        return false;
+    }
+
+    file.write(
+        reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(file);
+}
+
+std::vector<uint8_t> asw::input::load_recording(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        asw::log::error("Failed to open {} for reading", path);
+        return {};
+    }
+
+    return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+}
+
+void asw::input::_begin_tick()
+{
+    if (!replaying) {
+        return;
+    }
+
+    Reader reader;
+    InputEvent event;
+
+    while (replaying) {
+        const auto type = reader.u8();
+
+        if (!reader.ok()) {
+            asw::log::info("Input replay finished");
+            stop_replay();
+            return;
+        }
+
+        if (type == END_OF_TICK) {
+            return;
+        }
+
+        if (!read_event(reader, type, event)) {
+            asw::log::error("Corrupt input recording at byte {}", replay_cursor);
+            stop_replay();
+            return;
+        }
+
+        if (recording) {
+            write_event(event);
+        }
+
+        apply(event);
+    }
+}
+
+void asw::input::_end_tick()
+{
+    if (recording) {
+        write_u8(END_OF_TICK);
+    }
+}
+
+void asw::input::_dispatch(const InputEvent& event)
+{
+    // Live input is ignored while a recording drives the hooks
+    if (replaying) {
+        return;
+    }
+
+    if (recording) {
+        write_event(event);
+    }
+
+    apply(event);
+}
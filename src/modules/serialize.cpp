@@ -0,0 +1,353 @@
+#include "./asw/modules/serialize.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <unordered_map>
+
+#include "./asw/modules/log.h"
+
+namespace {
+// Registered types, by C++ type and by name hash
+std::unordered_map<std::type_index, asw::serialize::TypeInfo> types;
+std::unordered_map<uint64_t, std::type_index> types_by_hash;
+
+/// @brief Store an integer in little endian byte order.
+template <typename T> void store_le(uint8_t* out, T value)
+{
+    if constexpr (std::endian::native == std::endian::little) {
+        std::memcpy(out, &value, sizeof(T));
+    } else {
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            out[i] = static_cast<uint8_t>(value >> (i * 8));
+        }
+    }
+}
+
+/// @brief Load an integer stored in little endian byte order.
+template <typename T> T load_le(const uint8_t* in)
+{
+    T value {};
+    if constexpr (std::endian::native == std::endian::little) {
+        std::memcpy(&value, in, sizeof(T));
+    } else {
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            value |= static_cast<T>(static_cast<T>(in[i]) << (i * 8));
+        }
+    }
+    return value;
+}
+
+} // namespace
+
+namespace asw::serialize {
+
+// --- BinaryWriter ---
+
+uint8_t* BinaryWriter::grow(size_t size)
+{
+    if (size > buffer_.size() - size_) {
+        buffer_.resize(std::max(buffer_.size() * 2, size_ + size));
+    }
+
+    uint8_t* out = buffer_.data() + size_;
+    size_ += size;
+    return out;
+}
+
+template <typename T> void BinaryWriter::append(T value)
+{
+    store_le(grow(sizeof(T)), value);
+}
+
+void BinaryWriter::write_u8(uint8_t value)
+{
+    *grow(1) = value;
+}
+
+void BinaryWriter::write_u16(uint16_t value)
+{
+    append(value);
+}
+
+void BinaryWriter::write_u32(uint32_t value)
+{
+    append(value);
+}
+
+void BinaryWriter::write_u64(uint64_t value)
+{
+    append(value);
+}
+
+void BinaryWriter::write_i32(int32_t value)
+{
+    append(static_cast<uint32_t>(value));
+}
+
+void BinaryWriter::write_f32(float value)
+{
+    append(std::bit_cast<uint32_t>(value));
+}
+
+void BinaryWriter::write_bool(bool value)
+{
+    *grow(1) = value ? 1 : 0;
+}
+
+void BinaryWriter::write_string(std::string_view value)
+{
+    write_u32(static_cast<uint32_t>(value.size()));
+    write_bytes({ reinterpret_cast<const uint8_t*>(value.data()), value.size() });
+}
+
+void BinaryWriter::write_bytes(std::span<const uint8_t> data)
+{
+    if (!data.empty()) {
+        std::memcpy(grow(data.size()), data.data(), data.size());
+    }
+}
+
+void BinaryWriter::write_vec2(const Vec2<float>& value)
+{
+    write_f32(value.x);
+    write_f32(value.y);
+}
+
+void BinaryWriter::write_quad(const Quad<float>& value)
+{
+    write_vec2(value.position);
+    write_vec2(value.size);
+}
+
+void BinaryWriter::patch_u32(size_t offset, uint32_t value)
+{
+    if (offset + sizeof(uint32_t) > size_) {
+        asw::log::error("Cannot patch past the end of a {} byte buffer", size_);
+        return;
+    }
+
+    store_le(buffer_.data() + offset, value);
+}
+
+void BinaryWriter::reserve(size_t size)
+{
+    if (size > buffer_.size()) {
+        buffer_.resize(size);
+    }
+}
+
+size_t BinaryWriter::size() const
+{
+    return size_;
+}
+
+std::span<const uint8_t> BinaryWriter::data() const
+{
+    return { buffer_.data(), size_ };
+}
+
+std::vector<uint8_t> BinaryWriter::take()
+{
+    buffer_.resize(size_);
+    size_ = 0;
+    return std::move(buffer_);
+}
+
+void BinaryWriter::clear()
+{
+    size_ = 0;
+}
+
+// --- BinaryReader ---
+
+BinaryReader::BinaryReader(std::span<const uint8_t> data)
+    : data_(data)
+{
+}
+
+const uint8_t* BinaryReader::claim(size_t size)
+{
+    if (!ok_ || size > data_.size() - cursor_) {
+        ok_ = false;
+        return nullptr;
+    }
+
+    const uint8_t* bytes = data_.data() + cursor_;
+    cursor_ += size;
+    return bytes;
+}
+
+uint8_t BinaryReader::read_u8()
+{
+    const uint8_t* bytes = claim(1);
+    return bytes != nullptr ? *bytes : 0;
+}
+
+uint16_t BinaryReader::read_u16()
+{
+    const uint8_t* bytes = claim(sizeof(uint16_t));
+    return bytes != nullptr ? load_le<uint16_t>(bytes) : 0;
+}
+
+uint32_t BinaryReader::read_u32()
+{
+    const uint8_t* bytes = claim(sizeof(uint32_t));
+    return bytes != nullptr ? load_le<uint32_t>(bytes) : 0;
+}
+
+uint64_t BinaryReader::read_u64()
+{
+    const uint8_t* bytes = claim(sizeof(uint64_t));
+    return bytes != nullptr ? load_le<uint64_t>(bytes) : 0;
+}
+
+int32_t BinaryReader::read_i32()
+{
+    return static_cast<int32_t>(read_u32());
+}
+
+float BinaryReader::read_f32()
+{
+    return std::bit_cast<float>(read_u32());
+}
+
+bool BinaryReader::read_bool()
+{
+    return read_u8() != 0;
+}
+
+std::string BinaryReader::read_string()
+{
+    const auto bytes = read_bytes(read_u32());
+    return { bytes.begin(), bytes.end() };
+}
+
+Vec2<float> BinaryReader::read_vec2()
+{
+    const float x = read_f32();
+    const float y = read_f32();
+    return { x, y };
+}
+
+Quad<float> BinaryReader::read_quad()
+{
+    const auto position = read_vec2();
+    const auto size = read_vec2();
+    return { position, size };
+}
+
+std::span<const uint8_t> BinaryReader::read_bytes(size_t size)
+{
+    const uint8_t* bytes = claim(size);
+    if (bytes == nullptr) {
+        return {};
+    }
+
+    return { bytes, size };
+}
+
+void BinaryReader::skip(size_t size)
+{
+    claim(size);
+}
+
+void BinaryReader::fail()
+{
+    ok_ = false;
+}
+
+bool BinaryReader::ok() const
+{
+    return ok_;
+}
+
+size_t BinaryReader::position() const
+{
+    return cursor_;
+}
+
+size_t BinaryReader::remaining() const
+{
+    return data_.size() - cursor_;
+}
+
+// --- Comparison ---
+
+uint64_t checksum(std::span<const uint8_t> data)
+{
+    // Eight bytes per step, mixed with multiply and xor shift
+    constexpr uint64_t PRIME = 0x9E3779B97F4A7C15ULL;
+    uint64_t hash = data.size() * PRIME;
+
+    size_t i = 0;
+    for (; i + 8 <= data.size(); i += 8) {
+        hash = (hash ^ load_le<uint64_t>(data.data() + i)) * PRIME;
+        hash ^= hash >> 32;
+    }
+
+    uint64_t tail = 0;
+    for (size_t shift = 0; i < data.size(); ++i, shift += 8) {
+        tail |= static_cast<uint64_t>(data[i]) << shift;
+    }
+
+    hash = (hash ^ tail) * PRIME;
+    return hash ^ (hash >> 29);
+}
+
+size_t find_first_difference(std::span<const uint8_t> a, std::span<const uint8_t> b)
+{
+    const size_t size = std::min(a.size(), b.size());
+
+    // Compare in words, then find the byte within the first differing word
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        if (std::memcmp(a.data() + i, b.data() + i, 8) != 0) {
+            break;
+        }
+    }
+
+    for (; i < size; ++i) {
+        if (a[i] != b[i]) {
+            return i;
+        }
+    }
+
+    return a.size() == b.size() ? SIZE_MAX : size;
+}
+
+// --- Type registry ---
+
+void register_type(std::type_index type, TypeInfo info)
+{
+    info.type = type;
+    info.hash = hash_type_name(info.name);
+
+    if (auto it = types_by_hash.find(info.hash); it != types_by_hash.end() && it->second != type) {
+        asw::log::error("Serialized type name \"{}\" collides with \"{}\"", info.name,
+            types.at(it->second).name);
+        return;
+    }
+
+    // Re-registering a type under a new name drops the old name
+    if (auto it = types.find(type); it != types.end()) {
+        types_by_hash.erase(it->second.hash);
+    }
+
+    types_by_hash.insert_or_assign(info.hash, type);
+    types.insert_or_assign(type, std::move(info));
+}
+
+const TypeInfo* find_type(std::type_index type)
+{
+    auto it = types.find(type);
+    return it != types.end() ? &it->second : nullptr;
+}
+
+const TypeInfo* find_type(uint64_t hash)
+{
+    auto it = types_by_hash.find(hash);
+    return it != types_by_hash.end() ? find_type(it->second) : nullptr;
+}
+
+} // namespace asw::serialize
@@ -4,17 +4,121 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
 
 #include "./asw/modules/log.h"
 
 namespace {
+/// @brief Per-sample policy and the counters needed to enforce it.
+struct SampleState {
+    asw::sound::SamplePolicy policy;
+    uint32_t instances { 0 };
+    uint64_t last_play_ns { 0 };
+    uint64_t last_tick { 0 };
+    asw::sound::Voice last_voice;
+    bool played { false };
+};
+
+/// @brief Bookkeeping for a single sound effect voice.
+struct VoiceSlot {
+    MIX_Track* track { nullptr };
+    SampleState* sample_state { nullptr };
+    uint32_t generation { 0 };
+    uint64_t started { 0 };
+    float volume { 0.0F };
+    float attenuation { 1.0F };
+    int priority { 0 };
+    bool in_use { false };
+
+    // Positional state
+    asw::Vec2<float> position;
+    bool positional { false };
+    bool virtualized { false };
+
+    // Length of the sample in frames, negative if unknown
+    Sint64 length { -1 };
+    bool looping { false };
+
+    // Playback position and time when the voice went virtual, to keep time
+    Sint64 virtual_frame { 0 };
+    uint64_t virtual_since_ns { 0 };
+};
+
 float master_volume = 1.0F;
 float sfx_volume = 1.0F;
 float music_volume = 1.0F;
 
-std::array<MIX_Track*, 16> tracks;
-MIX_Track* music_track = nullptr;
+uint32_t voice_count = asw::sound::DEFAULT_VOICE_COUNT;
+asw::sound::StealMode steal_mode = asw::sound::StealMode::Oldest;
+uint64_t play_counter = 0;
+uint64_t current_tick = 0;
+
+// Last voice generation handed out. Shared by all slots and kept across
+// voice pool rebuilds, so a handle never matches a later voice.
+uint32_t voice_generation = 0;
+
+asw::Vec2<float> listener;
+float audible_radius = asw::sound::DEFAULT_AUDIBLE_RADIUS;
+
+std::vector<VoiceSlot> voices;
+
+/// @brief Policies keyed by sample. Nodes are stable, so voices can point at
+/// their sample's state directly.
+std::unordered_map<const MIX_Audio*, SampleState> sample_states;
+
+/// @brief Stack of idle voice indices. Capacity is reserved up front so the
+/// audio thread never allocates when it returns a voice.
+std::vector<uint32_t> free_voices;
+
+/// @brief A/B music decks. Crossfades start the next track on the idle deck
+/// and then swap, so there is never a gap between tracks.
+std::array<MIX_Track*, 2> music_decks { nullptr, nullptr };
+size_t music_deck = 0;
+
+/// @brief Loop start frames for music with an intro, keyed by music.
+std::unordered_map<const MIX_Audio*, Sint64> music_loop_points;
+
 MIX_Mixer* mixer = nullptr;
+bool offline = false;
+
+/// @brief Play option sets, created once so play calls never allocate.
+struct PlayOptions {
+    SDL_PropertiesID sfx_once { 0 };
+    SDL_PropertiesID sfx_loop { 0 };
+    SDL_PropertiesID music { 0 };
+};
+
+PlayOptions play_options;
+
+/// @brief Scoped mixer lock. Track stopped callbacks run on the audio thread
+/// with the mixer locked, so holding it keeps the free list consistent.
+/// Does nothing while the mixer is not initialized.
+class MixerLock {
+public:
+    MixerLock()
+        : locked_(mixer)
+    {
+        if (locked_ != nullptr) {
+            MIX_LockMixer(locked_);
+        }
+    }
+
+    ~MixerLock()
+    {
+        if (locked_ != nullptr) {
+            MIX_UnlockMixer(locked_);
+        }
+    }
+
+    MixerLock(const MixerLock&) = delete;
+    MixerLock& operator=(const MixerLock&) = delete;
+
+private:
+    MIX_Mixer* locked_;
+};
 
 float compute_sfx_volume(float vol)
 {
@@ -28,14 +132,399 @@ float compute_music_volume(float vol)
     return std::clamp(volume, 0.0F, 1.0F);
 }
 
-int find_free_track()
+void apply_pan(MIX_Track* track, float pan)
+{
+    // Stereo gains for panning using equal power panning
+    MIX_StereoGains gains;
+    gains.left = std::sqrt((1.0F - pan) * 0.5F);
+    gains.right = std::sqrt((1.0F + pan) * 0.5F);
+    MIX_SetTrackStereo(track, &gains);
+}
+
+void apply_gain(const VoiceSlot& voice)
+{
+    MIX_SetTrackGain(voice.track, compute_sfx_volume(voice.volume * voice.attenuation));
+}
+
+/// @brief Frame a virtual voice would be playing if it had kept playing.
+Sint64 virtual_position(const VoiceSlot& voice)
+{
+    const auto elapsed_ms = (SDL_GetTicksNS() - voice.virtual_since_ns) / 1'000'000;
+    return voice.virtual_frame + MIX_TrackMSToFrames(voice.track, static_cast<Sint64>(elapsed_ms));
+}
+
+/// @brief Check if a virtual one-shot would have finished by now.
+bool virtual_expired(const VoiceSlot& voice)
 {
-    for (size_t i = 0; i < tracks.size(); ++i) {
-        if (!MIX_TrackPlaying(tracks[i])) {
-            return static_cast<int>(i);
+    return !voice.looping && voice.length > 0 && virtual_position(voice) >= voice.length;
+}
+
+/// @brief Recompute attenuation and panning of a positional voice, pausing it
+/// while it is out of range. One-shots keep time while paused, and are
+/// stopped once they would have finished.
+void spatialize(VoiceSlot& voice)
+{
+    const auto offset = voice.position - listener;
+    const float distance = offset.magnitude();
+    const bool audible = distance < audible_radius;
+
+    if (!audible) {
+        if (!voice.virtualized) {
+            voice.virtualized = true;
+            voice.attenuation = 0.0F;
+            voice.virtual_frame = std::max<Sint64>(MIX_GetTrackPlaybackPosition(voice.track), 0);
+            voice.virtual_since_ns = SDL_GetTicksNS();
+            MIX_PauseTrack(voice.track);
+        } else if (virtual_expired(voice)) {
+            // The stopped callback releases the voice
+            MIX_StopTrack(voice.track, 0);
         }
+        return;
+    }
+
+    if (voice.virtualized) {
+        if (virtual_expired(voice)) {
+            MIX_StopTrack(voice.track, 0);
+            return;
+        }
+
+        if (!voice.looping) {
+            MIX_SetTrackPlaybackPosition(voice.track, virtual_position(voice));
+        }
+    }
+
+    voice.attenuation = 1.0F - (distance / audible_radius);
+    apply_gain(voice);
+    apply_pan(voice.track, std::clamp(offset.x / audible_radius, -1.0F, 1.0F));
+
+    if (voice.virtualized) {
+        voice.virtualized = false;
+        MIX_ResumeTrack(voice.track);
+    }
+}
+
+void retire_voice(VoiceSlot& voice)
+{
+    voice.in_use = false;
+    voice.positional = false;
+    voice.virtualized = false;
+
+    if (voice.sample_state != nullptr) {
+        voice.sample_state->instances--;
+        voice.sample_state = nullptr;
+    }
+}
+
+void release_voice(uint32_t index)
+{
+    if (index >= voices.size() || !voices[index].in_use) {
+        return;
+    }
+
+    retire_voice(voices[index]);
+    free_voices.push_back(index);
+}
+
+void SDLCALL on_voice_stopped(void* userdata, MIX_Track* /*track*/)
+{
+    release_voice(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(userdata)));
+}
+
+/// @brief Pick a busy voice to steal for a sound of the given priority.
+///
+/// @return Index of the victim, or -1 if no voice may be stolen.
+///
+int64_t find_victim(int priority)
+{
+    int64_t victim = -1;
+
+    for (size_t i = 0; i < voices.size(); ++i) {
+        const auto& voice = voices[i];
+        if (!voice.in_use || voice.priority > priority) {
+            continue;
+        }
+
+        if (victim < 0) {
+            victim = static_cast<int64_t>(i);
+            continue;
+        }
+
+        // Prefer the lowest priority, then voices nobody can hear, then apply
+        // the steal mode
+        const auto& best = voices[victim];
+        bool better = voice.priority < best.priority;
+        if (voice.priority == best.priority && voice.virtualized != best.virtualized) {
+            better = voice.virtualized;
+        } else if (voice.priority == best.priority) {
+            better = steal_mode == asw::sound::StealMode::Quietest
+                ? voice.volume * voice.attenuation < best.volume * best.attenuation
+                : voice.started < best.started;
+        }
+
+        if (better) {
+            victim = static_cast<int64_t>(i);
+        }
+    }
+
+    return victim;
+}
+
+/// @brief Claim a voice for a new sound. Must be called with the mixer locked.
+///
+/// @return Index of the claimed voice, or -1 if the sound should be dropped.
+///
+int64_t acquire_voice(int priority)
+{
+    int64_t index = -1;
+
+    if (!free_voices.empty()) {
+        index = free_voices.back();
+        free_voices.pop_back();
+    } else if (steal_mode != asw::sound::StealMode::None) {
+        index = find_victim(priority);
+        if (index < 0) {
+            return -1;
+        }
+
+        // Retire first so the stopped callback does not push it to the free list
+        retire_voice(voices[index]);
+        MIX_StopTrack(voices[index].track, 0);
+    } else {
+        return -1;
+    }
+
+    auto& voice = voices[index];
+    voice.in_use = true;
+    voice.attenuation = 1.0F;
+    voice.priority = priority;
+    voice.started = ++play_counter;
+
+    // Generation 0 is reserved for invalid handles
+    if (++voice_generation == 0) {
+        voice_generation = 1;
+    }
+    voice.generation = voice_generation;
+
+    return index;
+}
+
+/// @brief Resolve a handle to its voice, or nullptr if the handle is stale.
+VoiceSlot* resolve(asw::sound::Voice handle)
+{
+    if (!handle.is_valid() || handle.index >= voices.size()) {
+        return nullptr;
+    }
+
+    auto& voice = voices[handle.index];
+    if (!voice.in_use || voice.generation != handle.generation) {
+        return nullptr;
+    }
+
+    return &voice;
+}
+
+/// @brief Apply a sample's policy to a new play request.
+///
+/// @return True if the play should go ahead. Coalesced plays return false and
+/// set @p merged to the voice that absorbed them.
+///
+bool admit_play(SampleState& state, float volume, asw::sound::Voice& merged)
+{
+    const auto& policy = state.policy;
+
+    if (policy.coalesce && state.played && state.last_tick == current_tick) {
+        if (auto* voice = resolve(state.last_voice); voice != nullptr) {
+            voice->volume = std::min(voice->volume + volume, 1.0F);
+            apply_gain(*voice);
+            merged = state.last_voice;
+            return false;
+        }
+    }
+
+    if (policy.max_instances > 0 && state.instances >= policy.max_instances) {
+        return false;
+    }
+
+    if (policy.min_interval_s > 0.0F && state.played) {
+        const auto min_interval_ns = static_cast<uint64_t>(policy.min_interval_s * 1e9F);
+        if (SDL_GetTicksNS() - state.last_play_ns < min_interval_ns) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// @brief Start a sample on a free voice. Shared by play and play_at.
+asw::sound::Voice start_voice(const asw::Sample& sample, float volume, float pan, bool loop,
+    int priority, const asw::Vec2<float>* position)
+{
+    const MixerLock lock;
+
+    // Only samples with a policy pay for the lookup
+    SampleState* state = nullptr;
+    if (!sample_states.empty()) {
+        if (auto it = sample_states.find(sample.get()); it != sample_states.end()) {
+            state = &it->second;
+
+            asw::sound::Voice merged;
+            if (!admit_play(*state, volume, merged)) {
+                return merged;
+            }
+        }
+    }
+
+    const auto index = acquire_voice(priority);
+    if (index < 0) {
+        return {};
+    }
+
+    auto& voice = voices[index];
+    voice.volume = volume;
+    voice.looping = loop;
+    voice.length = MIX_GetAudioDuration(sample.get());
+
+    MIX_SetTrackAudio(voice.track, sample.get());
+
+    if (position != nullptr) {
+        voice.positional = true;
+        voice.position = *position;
+        spatialize(voice);
+    } else {
+        apply_gain(voice);
+        apply_pan(voice.track, pan);
+    }
+
+    // Play the track, looping if requested
+    const auto options = loop ? play_options.sfx_loop : play_options.sfx_once;
+    if (!MIX_PlayTrack(voice.track, options)) {
+        release_voice(static_cast<uint32_t>(index));
+        return {};
+    }
+
+    // Emitters that start out of range are never mixed, but their time runs
+    // from now
+    if (voice.virtualized) {
+        MIX_PauseTrack(voice.track);
+        voice.virtual_frame = 0;
+        voice.virtual_since_ns = SDL_GetTicksNS();
+    }
+
+    const asw::sound::Voice handle { static_cast<uint32_t>(index), voice.generation };
+
+    if (state != nullptr) {
+        voice.sample_state = state;
+        state->instances++;
+        state->last_play_ns = SDL_GetTicksNS();
+        state->last_tick = current_tick;
+        state->last_voice = handle;
+        state->played = true;
+    }
+
+    return handle;
+}
+
+/// @brief Start music on a deck. Must be called with the mixer locked.
+void start_music(MIX_Track* deck, const asw::Music& music, float volume, float fade_in_s)
+{
+    MIX_SetTrackGain(deck, compute_music_volume(volume));
+    MIX_SetTrackAudio(deck, music.get());
+
+    Sint64 loop_start = 0;
+    if (auto it = music_loop_points.find(music.get()); it != music_loop_points.end()) {
+        loop_start = it->second;
+    }
+
+    const auto fade_in_frames = MIX_TrackMSToFrames(deck, static_cast<Sint64>(fade_in_s * 1000.0F));
+
+    if (fade_in_frames <= 0 && loop_start <= 0) {
+        MIX_PlayTrack(deck, play_options.music);
+        return;
+    }
+
+    // Fades and loop points vary per start, give them their own short lived
+    // set so the shared one is never written
+    const SDL_PropertiesID options = SDL_CreateProperties();
+    if (options == 0) {
+        asw::log::error("Failed to create music play options: {}", SDL_GetError());
+        MIX_PlayTrack(deck, play_options.music);
+        return;
+    }
+
+    SDL_SetNumberProperty(options, MIX_PROP_PLAY_LOOPS_NUMBER, -1);
+    SDL_SetNumberProperty(options, MIX_PROP_PLAY_FADE_IN_FRAMES_NUMBER, fade_in_frames);
+    SDL_SetNumberProperty(options, MIX_PROP_PLAY_LOOP_START_FRAME_NUMBER, loop_start);
+    MIX_PlayTrack(deck, options);
+    SDL_DestroyProperties(options);
+}
+
+bool create_voices()
+{
+    voices.resize(voice_count);
+    free_voices.clear();
+    free_voices.reserve(voice_count);
+
+    for (uint32_t i = 0; i < voice_count; ++i) {
+        auto& voice = voices[i];
+        voice.track = MIX_CreateTrack(mixer);
+        if (voice.track == nullptr) {
+            asw::log::error("Failed to create track: {}", SDL_GetError());
+            return false;
+        }
+
+        auto* userdata = reinterpret_cast<void*>(static_cast<uintptr_t>(i));
+        MIX_SetTrackStoppedCallback(voice.track, on_voice_stopped, userdata);
+
+        // Push in reverse so voice 0 is handed out first
+        free_voices.push_back(voice_count - 1 - i);
+    }
+
+    return true;
+}
+
+bool create_play_options()
+{
+    play_options.sfx_once = SDL_CreateProperties();
+    play_options.sfx_loop = SDL_CreateProperties();
+    play_options.music = SDL_CreateProperties();
+
+    if (play_options.sfx_once == 0 || play_options.sfx_loop == 0 || play_options.music == 0) {
+        asw::log::error("Failed to create play options: {}", SDL_GetError());
+        return false;
+    }
+
+    SDL_SetNumberProperty(play_options.sfx_once, MIX_PROP_PLAY_LOOPS_NUMBER, 0);
+    SDL_SetNumberProperty(play_options.sfx_loop, MIX_PROP_PLAY_LOOPS_NUMBER, -1);
+    SDL_SetNumberProperty(play_options.music, MIX_PROP_PLAY_LOOPS_NUMBER, -1);
+    return true;
+}
+
+void destroy_play_options()
+{
+    for (auto id : { play_options.sfx_once, play_options.sfx_loop, play_options.music }) {
+        if (id != 0) {
+            SDL_DestroyProperties(id);
+        }
+    }
+
+    play_options = {};
+}
+
+void destroy_voices()
+{
+    for (auto& voice : voices) {
+        if (voice.track != nullptr) {
+            MIX_SetTrackStoppedCallback(voice.track, nullptr, nullptr);
+            MIX_DestroyTrack(voice.track);
+        }
+    }
+
+    voices.clear();
+    free_voices.clear();
+
+    for (auto& [audio, state] : sample_states) {
+        state.instances = 0;
     }
-    return -1;
 }
 
 } // namespace
@@ -50,12 +539,15 @@ void asw::sound::_shutdown()
     auto* m = mixer;
     mixer = nullptr;
     if (m != nullptr) {
+        destroy_voices();
+        destroy_play_options();
+        music_decks = { nullptr, nullptr };
         MIX_DestroyMixer(m);
     }
     MIX_Quit();
 }
 
-bool asw::sound::_init()
+bool asw::sound::_init(Backend backend)
 {
     if (!MIX_Init()) {
         asw::log::error("Failed to initialize SDL_mixer: {}", SDL_GetError());
@@ -70,95 +562,416 @@ bool asw::sound::_init()
     // Initialize SDL_mixer
     SDL_AudioSpec spec;
     spec.format = SDL_AUDIO_S16LE;
-    spec.freq = 44100;
-    spec.channels = 2;
+    spec.freq = MIXER_FREQUENCY;
+    spec.channels = MIXER_CHANNELS;
+
+    offline = backend == Backend::Offline;
+    if (offline) {
+        mixer = MIX_CreateMixer(&spec);
+    } else {
+        mixer = MIX_CreateMixerDevice(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec);
+    }
 
-    mixer = MIX_CreateMixerDevice(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec);
     if (mixer == nullptr) {
         asw::log::error("Failed to create mixer: {}", SDL_GetError());
         return false;
     }
 
-    for (auto& track : tracks) {
-        track = MIX_CreateTrack(mixer);
-        if (track == nullptr) {
-            asw::log::error("Failed to create track: {}", SDL_GetError());
+    if (!create_play_options() || !create_voices()) {
+        return false;
+    }
+
+    for (auto& deck : music_decks) {
+        deck = MIX_CreateTrack(mixer);
+        if (deck == nullptr) {
+            asw::log::error("Failed to create music track: {}", SDL_GetError());
             return false;
         }
     }
 
-    music_track = MIX_CreateTrack(mixer);
-    if (music_track == nullptr) {
-        asw::log::error("Failed to create music track: {}", SDL_GetError());
+    return true;
+}
+
+bool asw::sound::is_offline()
+{
+    return mixer != nullptr && offline;
+}
+
+bool asw::sound::render(std::span<int16_t> buffer)
+{
+    if (!is_offline()) {
+        asw::log::warn("render() requires the offline sound backend");
+        return false;
+    }
+
+    const auto bytes = static_cast<int>(buffer.size_bytes());
+    if (MIX_Generate(mixer, buffer.data(), bytes) < 0) {
+        asw::log::error("Failed to render audio: {}", SDL_GetError());
         return false;
     }
 
     return true;
 }
 
-void asw::sound::play(const asw::Sample& sample, float volume, float pan, bool loop)
+std::vector<int16_t> asw::sound::render(float seconds)
 {
-    const int channel = find_free_track();
-    if (channel >= 0) {
-        // Find first free track and play sample on it
-        auto& track = tracks[channel];
-        MIX_SetTrackAudio(track, sample.get());
-        MIX_SetTrackGain(track, compute_sfx_volume(volume));
+    const auto frames = static_cast<size_t>(std::max(seconds, 0.0F) * MIXER_FREQUENCY);
+    std::vector<int16_t> buffer(frames * MIXER_CHANNELS);
 
-        // Stereo gains for panning using equal power panning
-        const float left = std::sqrtf((1.0F - pan) * 0.5F);
-        const float right = std::sqrtf((1.0F + pan) * 0.5F);
+    if (!render(buffer)) {
+        return {};
+    }
 
-        MIX_StereoGains gains;
-        gains.left = left;
-        gains.right = right;
-        MIX_SetTrackStereo(track, &gains);
+    return buffer;
+}
+
+bool asw::sound::render_to_wav(const std::string& path, float seconds)
+{
+    const auto samples = render(seconds);
+    if (samples.empty()) {
+        return false;
+    }
 
-        // Play the track, looping if requested
-        const SDL_PropertiesID options = SDL_CreateProperties();
-        SDL_SetNumberProperty(options, MIX_PROP_PLAY_LOOPS_NUMBER, loop ? -1 : 0);
-        MIX_PlayTrack(track, options);
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        asw::log::error("Failed to open {} for writing", path);
+        return false;
+    }
+
+    const auto write_u32 = [&file](uint32_t value) {
+        const std::array<char, 4> bytes { static_cast<char>(value & 0xFF),
+            static_cast<char>((value >> 8) & 0xFF), static_cast<char>((value >> 16) & 0xFF),
+            static_cast<char>((value >> 24) & 0xFF) };
+        file.write(bytes.data(), bytes.size());
+    };
+
+    const auto write_u16 = [&file](uint16_t value) {
+        const std::array<char, 2> bytes { static_cast<char>(value & 0xFF),
+            static_cast<char>((value >> 8) & 0xFF) };
+        file.write(bytes.data(), bytes.size());
+    };
+
+    // Canonical 44 byte PCM header
+    constexpr uint16_t bits = 16;
+    constexpr uint16_t block_align = MIXER_CHANNELS * (bits / 8);
+    const auto data_size = static_cast<uint32_t>(samples.size() * sizeof(int16_t));
+
+    file.write("RIFF", 4);
+    write_u32(36 + data_size);
+    file.write("WAVEfmt ", 8);
+    write_u32(16);
+    write_u16(1);
+    write_u16(MIXER_CHANNELS);
+    write_u32(MIXER_FREQUENCY);
+    write_u32(MIXER_FREQUENCY * block_align);
+    write_u16(block_align);
+    write_u16(bits);
+    file.write("data", 4);
+    write_u32(data_size);
+
+    // Samples are little endian, matching the SDL_AUDIO_S16LE mixer format
+    for (const auto sample : samples) {
+        write_u16(static_cast<uint16_t>(sample));
     }
+
+    return static_cast<bool>(file);
 }
 
-void asw::sound::play_music(const asw::Music& sample, float volume, float fade_in_s)
+void asw::sound::_update()
 {
-    MIX_SetTrackGain(music_track, compute_music_volume(volume));
-    MIX_SetTrackAudio(music_track, sample.get());
+    current_tick++;
 
-    const SDL_PropertiesID options = SDL_CreateProperties();
-    SDL_SetNumberProperty(options, MIX_PROP_PLAY_LOOPS_NUMBER, -1);
-    SDL_SetNumberProperty(
-        options, MIX_PROP_PLAY_FADE_IN_MILLISECONDS_NUMBER, static_cast<int>(fade_in_s * 1000.0F));
-    MIX_PlayTrack(music_track, options);
+    if (mixer == nullptr) {
+        return;
+    }
+
+    // One pass over the voice array, under a single lock
+    const MixerLock lock;
+    for (auto& voice : voices) {
+        if (voice.in_use && voice.positional) {
+            spatialize(voice);
+        }
+    }
 }
 
-void asw::sound::stop_music(float fade_out_s)
+void asw::sound::set_sample_policy(const asw::Sample& sample, const SamplePolicy& policy)
+{
+    if (sample == nullptr) {
+        return;
+    }
+
+    const MixerLock lock;
+    sample_states[sample.get()].policy = policy;
+}
+
+void asw::sound::clear_sample_policy(const asw::Sample& sample)
+{
+    if (sample == nullptr) {
+        return;
+    }
+
+    _forget_sample(sample.get());
+}
+
+void asw::sound::_forget_sample(const MIX_Audio* audio)
+{
+    const MixerLock lock;
+
+    const auto it = sample_states.find(audio);
+    if (it == sample_states.end()) {
+        return;
+    }
+
+    // Detach voices still pointing at the state before it goes away
+    for (auto& voice : voices) {
+        if (voice.sample_state == &it->second) {
+            voice.sample_state = nullptr;
+        }
+    }
+
+    sample_states.erase(it);
+}
+
+void asw::sound::set_voice_count(uint32_t count)
+{
+    voice_count = std::max(count, 1U);
+
+    if (mixer == nullptr) {
+        return;
+    }
+
+    const MixerLock lock;
+    destroy_voices();
+    create_voices();
+}
+
+uint32_t asw::sound::get_voice_count()
+{
+    return voice_count;
+}
+
+uint32_t asw::sound::get_active_voice_count()
+{
+    if (mixer == nullptr) {
+        return 0;
+    }
+
+    const MixerLock lock;
+    return static_cast<uint32_t>(voices.size() - free_voices.size());
+}
+
+void asw::sound::set_steal_mode(StealMode mode)
+{
+    steal_mode = mode;
+}
+
+asw::sound::Voice asw::sound::play(
+    const asw::Sample& sample, float volume, float pan, bool loop, int priority)
+{
+    if (mixer == nullptr || sample == nullptr) {
+        return {};
+    }
+
+    return start_voice(sample, volume, pan, loop, priority, nullptr);
+}
+
+asw::sound::Voice asw::sound::play_at(const asw::Sample& sample, const asw::Vec2<float>& position,
+    float volume, bool loop, int priority)
+{
+    if (mixer == nullptr || sample == nullptr) {
+        return {};
+    }
+
+    return start_voice(sample, volume, 0.0F, loop, priority, &position);
+}
+
+void asw::sound::set_voice_position(Voice voice, const asw::Vec2<float>& position)
+{
+    if (mixer == nullptr) {
+        return;
+    }
+
+    // Picked up by the batched update in _update()
+    const MixerLock lock;
+    if (auto* slot = resolve(voice); slot != nullptr && slot->positional) {
+        slot->position = position;
+    }
+}
 
+bool asw::sound::is_voice_virtual(Voice voice)
 {
+    if (mixer == nullptr) {
+        return false;
+    }
+
+    const MixerLock lock;
+    const auto* slot = resolve(voice);
+    return slot != nullptr && slot->virtualized;
+}
+
+void asw::sound::set_listener(const asw::Vec2<float>& position)
+{
+    listener = position;
+}
+
+void asw::sound::set_listener(const asw::Quad<float>& view)
+{
+    listener = view.get_center();
+}
+
+asw::Vec2<float> asw::sound::get_listener()
+{
+    return listener;
+}
+
+void asw::sound::set_audible_radius(float radius)
+{
+    audible_radius = std::max(radius, 1.0F);
+}
+
+void asw::sound::set_voice_volume(Voice voice, float volume)
+{
+    if (mixer == nullptr) {
+        return;
+    }
+
+    const MixerLock lock;
+    if (auto* slot = resolve(voice); slot != nullptr) {
+        slot->volume = volume;
+        apply_gain(*slot);
+    }
+}
+
+void asw::sound::set_voice_pan(Voice voice, float pan)
+{
+    if (mixer == nullptr) {
+        return;
+    }
+
+    const MixerLock lock;
+    if (auto* slot = resolve(voice); slot != nullptr) {
+        apply_pan(slot->track, pan);
+    }
+}
+
+void asw::sound::stop_voice(Voice voice, float fade_out_s)
+{
+    if (mixer == nullptr) {
+        return;
+    }
+
+    const MixerLock lock;
+    if (auto* slot = resolve(voice); slot != nullptr) {
+        const auto fade_out_frames
+            = MIX_TrackMSToFrames(slot->track, static_cast<Sint64>(fade_out_s * 1000.0F));
+        MIX_StopTrack(slot->track, fade_out_frames);
+    }
+}
+
+bool asw::sound::is_voice_playing(Voice voice)
+{
+    if (mixer == nullptr) {
+        return false;
+    }
+
+    const MixerLock lock;
+    return resolve(voice) != nullptr;
+}
+
+void asw::sound::play_music(const asw::Music& sample, float volume, float fade_in_s)
+{
+    if (mixer == nullptr || sample == nullptr) {
+        return;
+    }
+
+    const MixerLock lock;
+
+    // Cut anything left on the idle deck from an earlier crossfade
+    MIX_StopTrack(music_decks[1 - music_deck], 0);
+    start_music(music_decks[music_deck], sample, volume, fade_in_s);
+}
+
+void asw::sound::crossfade_music(const asw::Music& sample, float duration_s, float volume)
+{
+    if (mixer == nullptr || sample == nullptr) {
+        return;
+    }
+
+    // Both decks change under one lock, so the fades begin on the same frame
+    const MixerLock lock;
+
+    auto* outgoing = music_decks[music_deck];
+    music_deck = 1 - music_deck;
+    auto* incoming = music_decks[music_deck];
+
+    MIX_StopTrack(incoming, 0);
+    start_music(incoming, sample, volume, duration_s);
+
     const auto fade_out_frames
-        = MIX_TrackMSToFrames(music_track, static_cast<Sint64>(fade_out_s * 1000.0F));
-    MIX_StopTrack(music_track, fade_out_frames);
+        = MIX_TrackMSToFrames(outgoing, static_cast<Sint64>(duration_s * 1000.0F));
+    MIX_StopTrack(outgoing, fade_out_frames);
+}
+
+void asw::sound::set_music_loop_point(const asw::Music& sample, int64_t loop_start_frame)
+{
+    if (sample == nullptr) {
+        return;
+    }
+
+    if (loop_start_frame <= 0) {
+        music_loop_points.erase(sample.get());
+        return;
+    }
+
+    music_loop_points[sample.get()] = loop_start_frame;
+}
+
+void asw::sound::stop_music(float fade_out_s)
+{
+    if (mixer == nullptr) {
+        return;
+    }
+
+    const MixerLock lock;
+    for (auto* deck : music_decks) {
+        const auto fade_out_frames
+            = MIX_TrackMSToFrames(deck, static_cast<Sint64>(fade_out_s * 1000.0F));
+        MIX_StopTrack(deck, fade_out_frames);
+    }
 }
 
 void asw::sound::pause_music()
 {
-    MIX_PauseTrack(music_track);
+    if (mixer == nullptr) {
+        return;
+    }
+
+    const MixerLock lock;
+    for (auto* deck : music_decks) {
+        MIX_PauseTrack(deck);
+    }
 }
 
 void asw::sound::resume_music()
 {
-    MIX_ResumeTrack(music_track);
+    if (mixer == nullptr) {
+        return;
+    }
+
+    const MixerLock lock;
+    for (auto* deck : music_decks) {
+        MIX_ResumeTrack(deck);
+    }
 }
 
 bool asw::sound::is_music_playing()
 {
-    return MIX_TrackPlaying(music_track);
+    return MIX_TrackPlaying(music_decks[music_deck]);
 }
 
 bool asw::sound::is_music_paused()
 {
-    return MIX_TrackPaused(music_track);
+    return MIX_TrackPaused(music_decks[music_deck]);
 }
 
 void asw::sound::set_master_volume(float volume)